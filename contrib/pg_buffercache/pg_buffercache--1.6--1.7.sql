@@ -32,6 +32,22 @@ GRANT EXECUTE ON FUNCTION pg_buffercache_os_pages(boolean) TO pg_monitor;
 GRANT SELECT ON pg_buffercache_os_pages TO pg_monitor;
 GRANT SELECT ON pg_buffercache_numa TO pg_monitor;
 
+-- Function to report the state of the clock-sweep partitions.
+CREATE FUNCTION pg_buffercache_clock_sweep(
+    OUT partition int4,
+    OUT first_buffer int4,
+    OUT num_buffers int4,
+    OUT next_victim_buffer int4,
+    OUT complete_passes int8,
+    OUT buffer_allocs int8,
+    OUT numa_node int4)
+RETURNS SETOF record
+AS 'MODULE_PATHNAME', 'pg_buffercache_clock_sweep'
+LANGUAGE C PARALLEL SAFE;
+
+REVOKE ALL ON FUNCTION pg_buffercache_clock_sweep() FROM PUBLIC;
+GRANT EXECUTE ON FUNCTION pg_buffercache_clock_sweep() TO pg_monitor;
+
 -- Functions to mark buffers as dirty.
 CREATE FUNCTION pg_buffercache_mark_dirty(
     IN int,
@@ -22,6 +22,7 @@
 #define NUM_BUFFERCACHE_PAGES_ELEM	9
 #define NUM_BUFFERCACHE_SUMMARY_ELEM 5
 #define NUM_BUFFERCACHE_USAGE_COUNTS_ELEM 4
+#define NUM_BUFFERCACHE_CLOCK_SWEEP_ELEM 7
 #define NUM_BUFFERCACHE_EVICT_ELEM 2
 #define NUM_BUFFERCACHE_EVICT_RELATION_ELEM 3
 #define NUM_BUFFERCACHE_EVICT_ALL_ELEM 3
@@ -101,6 +102,7 @@ PG_FUNCTION_INFO_V1(pg_buffercache_os_pages);
 PG_FUNCTION_INFO_V1(pg_buffercache_numa_pages);
 PG_FUNCTION_INFO_V1(pg_buffercache_summary);
 PG_FUNCTION_INFO_V1(pg_buffercache_usage_counts);
+PG_FUNCTION_INFO_V1(pg_buffercache_clock_sweep);
 PG_FUNCTION_INFO_V1(pg_buffercache_evict);
 PG_FUNCTION_INFO_V1(pg_buffercache_evict_relation);
 PG_FUNCTION_INFO_V1(pg_buffercache_evict_all);
@@ -714,6 +716,50 @@ pg_buffercache_usage_counts(PG_FUNCTION_ARGS)
 	return (Datum) 0;
 }
 
+Datum
+pg_buffercache_clock_sweep(PG_FUNCTION_ARGS)
+{
+	ReturnSetInfo *rsinfo = (ReturnSetInfo *) fcinfo->resultinfo;
+	Datum		values[NUM_BUFFERCACHE_CLOCK_SWEEP_ELEM];
+	bool		nulls[NUM_BUFFERCACHE_CLOCK_SWEEP_ELEM] = {0};
+	int			numPartitions = StrategyNumPartitions();
+
+	InitMaterializedSRF(fcinfo, 0);
+
+	for (int i = 0; i < numPartitions; i++)
+	{
+		int			first_buffer;
+		int			num_buffers;
+		int			numa_node;
+		uint32		next_victim_buffer;
+		uint32		complete_passes;
+		uint64		buffer_allocs;
+
+		StrategyGetPartitionInfo(i, &first_buffer, &num_buffers, &numa_node,
+								 &next_victim_buffer, &complete_passes,
+								 &buffer_allocs);
+
+		/* report buffer IDs 1-based, like pg_buffercache_pages() */
+		values[0] = Int32GetDatum(i);
+		values[1] = Int32GetDatum(first_buffer + 1);
+		values[2] = Int32GetDatum(num_buffers);
+		values[3] = Int32GetDatum(next_victim_buffer + 1);
+		values[4] = Int64GetDatum((int64) complete_passes);
+		values[5] = Int64GetDatum((int64) buffer_allocs);
+		if (numa_node >= 0)
+		{
+			values[6] = Int32GetDatum(numa_node);
+			nulls[6] = false;
+		}
+		else
+			nulls[6] = true;
+
+		tuplestore_putvalues(rsinfo->setResult, rsinfo->setDesc, values, nulls);
+	}
+
+	return (Datum) 0;
+}
+
 /*
  * Helper function to check if the user has superuser privileges.
  */
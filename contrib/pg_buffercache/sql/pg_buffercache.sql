@@ -18,6 +18,12 @@ from pg_buffercache_summary();
 
 SELECT count(*) > 0 FROM pg_buffercache_usage_counts() WHERE buffers >= 0;
 
+-- The clock-sweep partitions must cover all of shared buffers
+SELECT sum(num_buffers) = (SELECT count(*) FROM pg_buffercache) AS covered,
+       bool_and(next_victim_buffer >= first_buffer AND
+                next_victim_buffer < first_buffer + num_buffers) AS hand_ok
+FROM pg_buffercache_clock_sweep();
+
 -- Check that the functions / views can't be accessed by default. To avoid
 -- having to create a dedicated user, use the pg_database_owner pseudo-role.
 SET ROLE pg_database_owner;
@@ -26,6 +32,7 @@ SELECT * FROM pg_buffercache_os_pages;
 SELECT * FROM pg_buffercache_pages() AS p (wrong int);
 SELECT * FROM pg_buffercache_summary();
 SELECT * FROM pg_buffercache_usage_counts();
+SELECT * FROM pg_buffercache_clock_sweep();
 RESET role;
 
 -- Check that pg_monitor is allowed to query view / function
@@ -34,6 +41,7 @@ SELECT count(*) > 0 FROM pg_buffercache;
 SELECT count(*) > 0 FROM pg_buffercache_os_pages;
 SELECT buffers_used + buffers_unused > 0 FROM pg_buffercache_summary();
 SELECT count(*) > 0 FROM pg_buffercache_usage_counts();
+SELECT count(*) > 0 FROM pg_buffercache_clock_sweep();
 RESET role;
 
 
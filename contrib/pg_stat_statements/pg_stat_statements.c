@@ -2150,20 +2150,48 @@ entry_alloc(pgssHashKey *key, Size query_offset, int query_len, int encoding,
 }
 
 /*
- * qsort comparator for sorting into increasing usage order
+ * Reorder entries[0..n-1] so that entries[k] is the entry that sorting them
+ * into increasing usage order would put there, with no greater usage before
+ * it and no smaller usage after it.  This is quickselect, which takes linear
+ * time on average, rather than a full sort of the whole hash table.
  */
-static int
-entry_cmp(const void *lhs, const void *rhs)
+static void
+entry_select(pgssEntry **entries, int n, int k)
 {
-	double		l_usage = (*(pgssEntry *const *) lhs)->counters.usage;
-	double		r_usage = (*(pgssEntry *const *) rhs)->counters.usage;
+	int			lo = 0;
+	int			hi = n - 1;
 
-	if (l_usage < r_usage)
-		return -1;
-	else if (l_usage > r_usage)
-		return +1;
-	else
-		return 0;
+	Assert(k >= 0 && k < n);
+
+	while (lo < hi)
+	{
+		double		pivot = entries[lo + (hi - lo) / 2]->counters.usage;
+		int			i = lo;
+		int			j = hi;
+
+		while (i <= j)
+		{
+			while (entries[i]->counters.usage < pivot)
+				i++;
+			while (entries[j]->counters.usage > pivot)
+				j--;
+			if (i <= j)
+			{
+				pgssEntry  *tmp = entries[i];
+
+				entries[i++] = entries[j];
+				entries[j--] = tmp;
+			}
+		}
+
+		/* entries[lo..j] <= pivot, entries[j+1..i-1] = pivot, the rest >= */
+		if (k <= j)
+			hi = j;
+		else if (k >= i)
+			lo = i;
+		else
+			break;
+	}
 }
 
 /*
@@ -2183,8 +2211,8 @@ entry_dealloc(void)
 	int			nvalidtexts;
 
 	/*
-	 * Sort entries by usage and deallocate USAGE_DEALLOC_PERCENT of them.
-	 * While we're scanning the table, apply the decay factor to the usage
+	 * Find the least-used entries and deallocate USAGE_DEALLOC_PERCENT of
+	 * them.  While we're scanning the table, apply the decay factor to the usage
 	 * values, and update the mean query length.
 	 *
 	 * Note that the mean query length is almost immediately obsolete, since
@@ -2217,12 +2245,12 @@ entry_dealloc(void)
 		}
 	}
 
-	/* Sort into increasing order by usage */
-	qsort(entries, i, sizeof(pgssEntry *), entry_cmp);
-
 	/* Record the (approximate) median usage */
 	if (i > 0)
+	{
+		entry_select(entries, i, i / 2);
 		pgss->cur_median_usage = entries[i / 2]->counters.usage;
+	}
 	/* Record the mean query length */
 	if (nvalidtexts > 0)
 		pgss->mean_query_len = tottextlen / nvalidtexts;
@@ -2233,6 +2261,10 @@ entry_dealloc(void)
 	nvictims = Max(10, i * USAGE_DEALLOC_PERCENT / 100);
 	nvictims = Min(nvictims, i);
 
+	/* Move the nvictims least-used entries to the front */
+	if (nvictims > 0 && nvictims < i)
+		entry_select(entries, i, nvictims - 1);
+
 	for (i = 0; i < nvictims; i++)
 	{
 		hash_search(pgss_hash, &entries[i]->key, HASH_REMOVE, NULL);
@@ -47,7 +47,14 @@ typedef char trgm[3];
 } while(0)
 extern int	(*CMPTRGM) (const void *a, const void *b);
 
-#define ISWORDCHR(c, len)	(t_isalnum_with_len(c, len))
+/*
+ * ASCII characters are classified directly, since all locales agree about
+ * them; that avoids a conversion to pg_wchar and a call into the locale
+ * provider for each character of typical text.
+ */
+#define ISASCIIALNUM(a)		( ((a) >= 'a' && (a) <= 'z') || ((a) >= 'A' && (a) <= 'Z') || ((a) >= '0' && (a) <= '9') )
+#define ISWORDCHR(c, len)	\
+	( ((len) == 1 && !IS_HIGHBIT_SET(*(c))) ? ISASCIIALNUM(*(c)) : t_isalnum_with_len(c, len) )
 #define ISPRINTABLECHAR(a)	( isascii( *(unsigned char*)(a) ) && (isalnum( *(unsigned char*)(a) ) || *(unsigned char*)(a)==' ') )
 #define ISPRINTABLETRGM(t)	( ISPRINTABLECHAR( ((char*)(t)) ) && ISPRINTABLECHAR( ((char*)(t))+1 ) && ISPRINTABLECHAR( ((char*)(t))+2 ) )
 
@@ -299,7 +299,9 @@ find_word(char *str, int lenstr, char **endword)
 
 	while (beginword < endstr)
 	{
-		int			clen = pg_mblen_range(beginword, endstr);
+		/* ASCII bytes are single characters in every server encoding */
+		int			clen = IS_HIGHBIT_SET(*beginword) ?
+			pg_mblen_range(beginword, endstr) : 1;
 
 		if (ISWORDCHR(beginword, clen))
 			break;
@@ -312,7 +314,8 @@ find_word(char *str, int lenstr, char **endword)
 	*endword = beginword;
 	while (*endword < endstr)
 	{
-		int			clen = pg_mblen_range(*endword, endstr);
+		int			clen = IS_HIGHBIT_SET(**endword) ?
+			pg_mblen_range(*endword, endstr) : 1;
 
 		if (!ISWORDCHR(*endword, clen))
 			break;
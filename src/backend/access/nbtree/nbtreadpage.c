@@ -510,6 +510,9 @@ _bt_readpage(IndexScanDesc scan, ScanDirection dir, OffsetNumber offnum,
 		so->currPos.itemIndex = MaxTIDsPerBTreePage - 1;
 	}
 
+	/* currPos.items changed, so restart heap prefetching */
+	so->prefetchItem = -1;
+
 	/*
 	 * If _bt_set_startikey told us to temporarily treat the scan's keys as
 	 * nonrequired (possible only during scans with array keys), there must be
@@ -35,6 +35,7 @@
 #include "utils/fmgrprotos.h"
 #include "utils/index_selfuncs.h"
 #include "utils/memutils.h"
+#include "utils/spccache.h"
 
 
 /*
@@ -365,6 +366,10 @@ btbeginscan(Relation rel, int nkeys, int norderbys)
 	so->killedItems = NULL;		/* until needed */
 	so->numKilled = 0;
 
+	so->prefetchMaximum = 0;	/* until btrescan */
+	so->prefetchTarget = 0;
+	so->prefetchItem = -1;
+
 	/*
 	 * We don't know yet whether the scan will be index-only, so we do not
 	 * allocate the tuple workspace arrays until btrescan.  However, we set up
@@ -433,6 +438,19 @@ btrescan(IndexScanDesc scan, ScanKey scankey, int nscankeys,
 	BTScanPosUnpinIfPinned(so->markPos);
 	BTScanPosInvalidate(so->markPos);
 
+	/*
+	 * Plain index scans prefetch the heap pages they're about to visit.
+	 * Index-only scans mostly don't visit the heap at all, and bitmap scans
+	 * don't visit it through us.
+	 */
+	if (scan->heapRelation != NULL && !scan->xs_want_itup)
+		so->prefetchMaximum =
+			get_tablespace_io_concurrency(scan->heapRelation->rd_rel->reltablespace);
+	else
+		so->prefetchMaximum = 0;
+	so->prefetchTarget = 0;
+	so->prefetchItem = -1;
+
 	/*
 	 * Allocate tuple workspace arrays, if needed for an index-only scan and
 	 * not already done in a previous rescan call.  To save on palloc
@@ -571,6 +589,9 @@ btrestrpos(IndexScanDesc scan)
 		}
 		else
 			BTScanPosInvalidate(so->currPos);
+
+		/* currPos.items changed, so restart heap prefetching */
+		so->prefetchItem = -1;
 	}
 }
 
@@ -18,10 +18,12 @@
 #include "access/nbtree.h"
 #include "access/relscan.h"
 #include "access/xact.h"
+#include "common/int.h"
 #include "executor/instrument_node.h"
 #include "miscadmin.h"
 #include "pgstat.h"
 #include "storage/predicate.h"
+#include "utils/fmgroids.h"
 #include "utils/lsyscache.h"
 #include "utils/rel.h"
 
@@ -31,9 +33,11 @@ static Buffer _bt_moveright(Relation rel, Relation heaprel, BTScanInsert key,
 							Buffer buf, bool forupdate, BTStack stack,
 							int access);
 static OffsetNumber _bt_binsrch(Relation rel, BTScanInsert key, Buffer buf);
+static inline int32 _bt_compare_datum(ScanKey scankey, Datum datum);
 static int	_bt_binsrch_posting(BTScanInsert key, Page page,
 								OffsetNumber offnum);
 static inline void _bt_returnitem(IndexScanDesc scan, BTScanOpaque so);
+static void _bt_prefetch_heap(IndexScanDesc scan, BTScanOpaque so);
 static bool _bt_steppage(IndexScanDesc scan, ScanDirection dir);
 static bool _bt_readfirstpage(IndexScanDesc scan, OffsetNumber offnum,
 							  ScanDirection dir);
@@ -653,6 +657,36 @@ _bt_binsrch_posting(BTScanInsert key, Page page, OffsetNumber offnum)
 	return low;
 }
 
+/*
+ *	_bt_compare_datum() -- Apply scankey's ORDER proc to an index datum.
+ *
+ * Returns the ORDER proc's result for (datum, sk_argument).  The built-in
+ * ORDER procs for same-type int4, int8 and oid comparisons are evaluated
+ * inline, saving a function call through fmgr for each key compared during
+ * a descent of the index, which is the common case for point lookups.
+ */
+static inline int32
+_bt_compare_datum(ScanKey scankey, Datum datum)
+{
+	switch (scankey->sk_func.fn_oid)
+	{
+		case F_BTINT4CMP:
+			return pg_cmp_s32(DatumGetInt32(datum),
+							  DatumGetInt32(scankey->sk_argument));
+		case F_BTINT8CMP:
+			return pg_cmp_s64(DatumGetInt64(datum),
+							  DatumGetInt64(scankey->sk_argument));
+		case F_BTOIDCMP:
+			return pg_cmp_u32(DatumGetObjectId(datum),
+							  DatumGetObjectId(scankey->sk_argument));
+		default:
+			return DatumGetInt32(FunctionCall2Coll(&scankey->sk_func,
+												   scankey->sk_collation,
+												   datum,
+												   scankey->sk_argument));
+	}
+}
+
 /*----------
  *	_bt_compare() -- Compare insertion-type scankey to tuple on a page.
  *
@@ -758,10 +792,7 @@ _bt_compare(Relation rel,
 			 * to flip the sign of the comparison result.  (Unless it's a DESC
 			 * column, in which case we *don't* flip the sign.)
 			 */
-			result = DatumGetInt32(FunctionCall2Coll(&scankey->sk_func,
-													 scankey->sk_collation,
-													 datum,
-													 scankey->sk_argument));
+			result = _bt_compare_datum(scankey, datum);
 
 			if (!(scankey->sk_flags & SK_BT_DESC))
 				INVERT_COMPARE_RESULT(result);
@@ -1632,6 +1663,75 @@ _bt_returnitem(IndexScanDesc scan, BTScanOpaque so)
 	scan->xs_heaptid = currItem->heapTid;
 	if (so->currTuples)
 		scan->xs_itup = (IndexTuple) (so->currTuples + currItem->tupleOffset);
+
+	if (so->prefetchMaximum > 0)
+		_bt_prefetch_heap(scan, so);
+}
+
+/*
+ * _bt_prefetch_heap() -- Prefetch heap pages the scan will visit next
+ *
+ * Plain index scans fetch heap tuples one TID at a time, in index order, so
+ * with a cold cache the scan blocks on every heap page miss.  The TIDs of the
+ * remaining items in currPos are known in advance though, so we issue
+ * prefetches for the heap pages of the items after the one being returned.
+ * The number of distinct heap pages kept prefetched ahead ramps up to the heap
+ * tablespace's effective_io_concurrency, so that short scans (think LIMIT 1)
+ * don't pay for pages they'll never visit.  Consecutive items that point to
+ * the same heap page only count once, so the lookahead distance in items
+ * grows with the correlation between index and heap order.
+ *
+ * Called by _bt_returnitem, with currPos.itemIndex at the item being
+ * returned.
+ */
+static void
+_bt_prefetch_heap(IndexScanDesc scan, BTScanOpaque so)
+{
+	BTScanPos	pos = &so->currPos;
+	bool		forward = ScanDirectionIsForward(pos->dir);
+	BlockNumber curblock;
+
+	curblock = ItemPointerGetBlockNumber(&pos->items[pos->itemIndex].heapTid);
+
+	if (so->prefetchItem < 0 ||
+		(forward ? so->prefetchItem <= pos->itemIndex :
+		 so->prefetchItem >= pos->itemIndex))
+	{
+		/*
+		 * Nothing prefetched beyond the current item.  Restart the window
+		 * here; the current item's heap page is about to be read anyway.
+		 */
+		so->prefetchItem = pos->itemIndex;
+		so->prefetchBlock = curblock;
+		so->prefetchPending = 0;
+	}
+	else if (curblock != so->returnedBlock && so->prefetchPending > 0)
+	{
+		/* Reached one of the heap pages we prefetched */
+		so->prefetchPending--;
+	}
+	so->returnedBlock = curblock;
+
+	if (so->prefetchTarget < so->prefetchMaximum)
+		so->prefetchTarget++;
+
+	while (so->prefetchPending < so->prefetchTarget)
+	{
+		int			next = forward ? so->prefetchItem + 1 : so->prefetchItem - 1;
+		BlockNumber blkno;
+
+		if (next < pos->firstItem || next > pos->lastItem)
+			break;
+
+		so->prefetchItem = next;
+		blkno = ItemPointerGetBlockNumber(&pos->items[next].heapTid);
+		if (blkno != so->prefetchBlock)
+		{
+			PrefetchBuffer(scan->heapRelation, MAIN_FORKNUM, blkno);
+			so->prefetchBlock = blkno;
+			so->prefetchPending++;
+		}
+	}
 }
 
 /*
@@ -76,6 +76,7 @@
 #include "access/xlog.h"
 #include "access/xloginsert.h"
 #include "access/xlogutils.h"
+#include "common/hashfn.h"
 #include "miscadmin.h"
 #include "pg_trace.h"
 #include "pgstat.h"
@@ -272,6 +273,12 @@ MyOldestVisibleMXactIdSlot(void)
  *
  * We allocate the cache entries in a memory context that is deleted at
  * transaction end, so we don't need to do retail freeing of entries.
+ *
+ * The entries are kept in a list in LRU order, for pruning, and indexed by
+ * two hash tables, one on the MultiXactId and one on the (sorted) member
+ * set, so that lookups don't have to walk the whole list.  Lookups that miss
+ * are common: every multixact we haven't seen in this transaction yet is
+ * looked up in the cache before going to the SLRUs.
  */
 typedef struct mXactCacheEnt
 {
@@ -281,8 +288,76 @@ typedef struct mXactCacheEnt
 	MultiXactMember members[FLEXIBLE_ARRAY_MEMBER];
 } mXactCacheEnt;
 
+/* hash table entry for lookups by MultiXactId */
+typedef struct mXactCacheIdEnt
+{
+	MultiXactId multi;			/* hash key */
+	char		status;			/* for simplehash use */
+	mXactCacheEnt *entry;
+} mXactCacheIdEnt;
+
+/* hash key for lookups by member set */
+typedef struct mXactCacheSetKey
+{
+	int			nmembers;
+	MultiXactMember *members;	/* sorted */
+} mXactCacheSetKey;
+
+/* hash table entry for lookups by member set */
+typedef struct mXactCacheSetEnt
+{
+	mXactCacheSetKey key;		/* hash key, points into entry */
+	uint32		hash;			/* hash value of key */
+	char		status;			/* for simplehash use */
+	mXactCacheEnt *entry;
+} mXactCacheSetEnt;
+
+static inline uint32
+mxact_set_hash(mXactCacheSetKey key)
+{
+	return hash_bytes((const unsigned char *) key.members,
+					  key.nmembers * sizeof(MultiXactMember));
+}
+
+/*
+ * We assume the member sets are sorted, and that the unused bits in "status"
+ * are zeroed.
+ */
+static inline bool
+mxact_set_equal(mXactCacheSetKey a, mXactCacheSetKey b)
+{
+	return a.nmembers == b.nmembers &&
+		memcmp(a.members, b.members, a.nmembers * sizeof(MultiXactMember)) == 0;
+}
+
+#define SH_PREFIX		mxcache_id
+#define SH_ELEMENT_TYPE	mXactCacheIdEnt
+#define SH_KEY_TYPE		MultiXactId
+#define SH_KEY			multi
+#define SH_HASH_KEY(tb, key)	murmurhash32(key)
+#define SH_EQUAL(tb, a, b)		((a) == (b))
+#define SH_SCOPE		static inline
+#define SH_DECLARE
+#define SH_DEFINE
+#include "lib/simplehash.h"
+
+#define SH_PREFIX		mxcache_set
+#define SH_ELEMENT_TYPE	mXactCacheSetEnt
+#define SH_KEY_TYPE		mXactCacheSetKey
+#define SH_KEY			key
+#define SH_HASH_KEY(tb, key)	mxact_set_hash(key)
+#define SH_EQUAL(tb, a, b)		mxact_set_equal(a, b)
+#define SH_STORE_HASH
+#define SH_GET_HASH(tb, a)		((a)->hash)
+#define SH_SCOPE		static inline
+#define SH_DECLARE
+#define SH_DEFINE
+#include "lib/simplehash.h"
+
 #define MAX_CACHE_ENTRIES	256
 static dclist_head MXactCache = DCLIST_STATIC_INIT(MXactCache);
+static mxcache_id_hash *MXactCacheById = NULL;
+static mxcache_set_hash *MXactCacheBySet = NULL;
 static MemoryContext MXactContext = NULL;
 
 #ifdef MULTIXACT_DEBUG
@@ -1416,7 +1491,8 @@ mxactMemberComparator(const void *arg1, const void *arg2)
 static MultiXactId
 mXactCacheGetBySet(int nmembers, MultiXactMember *members)
 {
-	dlist_iter	iter;
+	mXactCacheSetKey key;
+	mXactCacheSetEnt *setent;
 
 	debug_elog3(DEBUG2, "CacheGet: looking for %s",
 				mxid_to_string(InvalidMultiXactId, nmembers, members));
@@ -1424,23 +1500,16 @@ mXactCacheGetBySet(int nmembers, MultiXactMember *members)
 	/* sort the array so comparison is easy */
 	qsort(members, nmembers, sizeof(MultiXactMember), mxactMemberComparator);
 
-	dclist_foreach(iter, &MXactCache)
+	if (MXactCacheBySet != NULL)
 	{
-		mXactCacheEnt *entry = dclist_container(mXactCacheEnt, node,
-												iter.cur);
-
-		if (entry->nmembers != nmembers)
-			continue;
-
-		/*
-		 * We assume the cache entries are sorted, and that the unused bits in
-		 * "status" are zeroed.
-		 */
-		if (memcmp(members, entry->members, nmembers * sizeof(MultiXactMember)) == 0)
+		key.nmembers = nmembers;
+		key.members = members;
+		setent = mxcache_set_lookup(MXactCacheBySet, key);
+		if (setent != NULL)
 		{
-			debug_elog3(DEBUG2, "CacheGet: found %u", entry->multi);
-			dclist_move_head(&MXactCache, iter.cur);
-			return entry->multi;
+			debug_elog3(DEBUG2, "CacheGet: found %u", setent->entry->multi);
+			dclist_move_head(&MXactCache, &setent->entry->node);
+			return setent->entry->multi;
 		}
 	}
 
@@ -1459,40 +1528,31 @@ mXactCacheGetBySet(int nmembers, MultiXactMember *members)
 static int
 mXactCacheGetById(MultiXactId multi, MultiXactMember **members)
 {
-	dlist_iter	iter;
+	mXactCacheIdEnt *ident;
 
 	debug_elog3(DEBUG2, "CacheGet: looking for %u", multi);
 
-	dclist_foreach(iter, &MXactCache)
+	if (MXactCacheById != NULL &&
+		(ident = mxcache_id_lookup(MXactCacheById, multi)) != NULL)
 	{
-		mXactCacheEnt *entry = dclist_container(mXactCacheEnt, node,
-												iter.cur);
+		mXactCacheEnt *entry = ident->entry;
+		MultiXactMember *ptr;
+		Size		size;
 
-		if (entry->multi == multi)
-		{
-			MultiXactMember *ptr;
-			Size		size;
-
-			size = sizeof(MultiXactMember) * entry->nmembers;
-			ptr = (MultiXactMember *) palloc(size);
+		size = sizeof(MultiXactMember) * entry->nmembers;
+		ptr = (MultiXactMember *) palloc(size);
 
-			memcpy(ptr, entry->members, size);
+		memcpy(ptr, entry->members, size);
 
-			debug_elog3(DEBUG2, "CacheGet: found %s",
-						mxid_to_string(multi,
-									   entry->nmembers,
-									   entry->members));
+		debug_elog3(DEBUG2, "CacheGet: found %s",
+					mxid_to_string(multi,
+								   entry->nmembers,
+								   entry->members));
 
-			/*
-			 * Note we modify the list while not using a modifiable iterator.
-			 * This is acceptable only because we exit the iteration
-			 * immediately afterwards.
-			 */
-			dclist_move_head(&MXactCache, iter.cur);
+		dclist_move_head(&MXactCache, &entry->node);
 
-			*members = ptr;
-			return entry->nmembers;
-		}
+		*members = ptr;
+		return entry->nmembers;
 	}
 
 	debug_elog2(DEBUG2, "CacheGet: not found");
@@ -1507,6 +1567,10 @@ static void
 mXactCachePut(MultiXactId multi, int nmembers, MultiXactMember *members)
 {
 	mXactCacheEnt *entry;
+	mXactCacheIdEnt *ident;
+	mXactCacheSetEnt *setent;
+	mXactCacheSetKey key;
+	bool		found;
 
 	debug_elog3(DEBUG2, "CachePut: storing %s",
 				mxid_to_string(multi, nmembers, members));
@@ -1518,6 +1582,10 @@ mXactCachePut(MultiXactId multi, int nmembers, MultiXactMember *members)
 		MXactContext = AllocSetContextCreate(TopTransactionContext,
 											 "MultiXact cache context",
 											 ALLOCSET_SMALL_SIZES);
+		MXactCacheById = mxcache_id_create(MXactContext, MAX_CACHE_ENTRIES,
+										   NULL);
+		MXactCacheBySet = mxcache_set_create(MXactContext, MAX_CACHE_ENTRIES,
+											 NULL);
 	}
 
 	entry = (mXactCacheEnt *)
@@ -1533,6 +1601,22 @@ mXactCachePut(MultiXactId multi, int nmembers, MultiXactMember *members)
 	qsort(entry->members, nmembers, sizeof(MultiXactMember), mxactMemberComparator);
 
 	dclist_push_head(&MXactCache, &entry->node);
+
+	/*
+	 * Index the new entry.  If an older entry has the same MultiXactId or the
+	 * same member set (the latter is possible if another backend created an
+	 * identical multixact), the new one takes its place in the index; the
+	 * older one just ages out of the list.
+	 */
+	ident = mxcache_id_insert(MXactCacheById, multi, &found);
+	ident->entry = entry;
+
+	key.nmembers = nmembers;
+	key.members = entry->members;
+	setent = mxcache_set_insert(MXactCacheBySet, key, &found);
+	setent->key = key;
+	setent->entry = entry;
+
 	if (dclist_count(&MXactCache) > MAX_CACHE_ENTRIES)
 	{
 		dlist_node *node;
@@ -1544,6 +1628,16 @@ mXactCachePut(MultiXactId multi, int nmembers, MultiXactMember *members)
 		debug_elog3(DEBUG2, "CachePut: pruning cached multi %u",
 					entry->multi);
 
+		ident = mxcache_id_lookup(MXactCacheById, entry->multi);
+		if (ident != NULL && ident->entry == entry)
+			mxcache_id_delete_item(MXactCacheById, ident);
+
+		key.nmembers = entry->nmembers;
+		key.members = entry->members;
+		setent = mxcache_set_lookup(MXactCacheBySet, key);
+		if (setent != NULL && setent->entry == entry)
+			mxcache_set_delete_item(MXactCacheBySet, setent);
+
 		pfree(entry);
 	}
 }
@@ -1620,6 +1714,8 @@ AtEOXact_MultiXact(void)
 	 * a child of TopTransactionContext, we needn't delete it explicitly.
 	 */
 	MXactContext = NULL;
+	MXactCacheById = NULL;
+	MXactCacheBySet = NULL;
 	dclist_init(&MXactCache);
 }
 
@@ -1686,6 +1782,8 @@ PostPrepare_MultiXact(FullTransactionId fxid)
 	 * Discard the local MultiXactId cache like in AtEOXact_MultiXact.
 	 */
 	MXactContext = NULL;
+	MXactCacheById = NULL;
+	MXactCacheBySet = NULL;
 	dclist_init(&MXactCache);
 }
 
@@ -834,6 +834,7 @@ SlruPhysicalReadPage(SlruCtl ctl, int64 pageno, int slotno)
 	off_t		offset = rpageno * BLCKSZ;
 	char		path[MAXPGPATH];
 	int			fd;
+	instr_time	io_start;
 
 	SlruFileName(ctl, path, segno);
 
@@ -862,6 +863,7 @@ SlruPhysicalReadPage(SlruCtl ctl, int64 pageno, int slotno)
 	}
 
 	errno = 0;
+	io_start = pgstat_prepare_io_time(track_io_timing);
 	pgstat_report_wait_start(WAIT_EVENT_SLRU_READ);
 	if (pg_pread(fd, shared->page_buffer[slotno], BLCKSZ, offset) != BLCKSZ)
 	{
@@ -872,6 +874,7 @@ SlruPhysicalReadPage(SlruCtl ctl, int64 pageno, int slotno)
 		return false;
 	}
 	pgstat_report_wait_end();
+	pgstat_count_slru_read_time(shared->slru_stats_idx, io_start);
 
 	if (CloseTransientFile(fd) != 0)
 	{
@@ -906,6 +909,7 @@ SlruPhysicalWritePage(SlruCtl ctl, int64 pageno, int slotno, SlruWriteAll fdata)
 	off_t		offset = rpageno * BLCKSZ;
 	char		path[MAXPGPATH];
 	int			fd = -1;
+	instr_time	io_start;
 
 	/* update the stats counter of written pages */
 	pgstat_count_slru_blocks_written(shared->slru_stats_idx);
@@ -1014,6 +1018,7 @@ SlruPhysicalWritePage(SlruCtl ctl, int64 pageno, int slotno, SlruWriteAll fdata)
 	}
 
 	errno = 0;
+	io_start = pgstat_prepare_io_time(track_io_timing);
 	pgstat_report_wait_start(WAIT_EVENT_SLRU_WRITE);
 	if (pg_pwrite(fd, shared->page_buffer[slotno], BLCKSZ, offset) != BLCKSZ)
 	{
@@ -1028,6 +1033,7 @@ SlruPhysicalWritePage(SlruCtl ctl, int64 pageno, int slotno, SlruWriteAll fdata)
 		return false;
 	}
 	pgstat_report_wait_end();
+	pgstat_count_slru_write_time(shared->slru_stats_idx, io_start);
 
 	/* Queue up a sync request for the checkpointer. */
 	if (ctl->sync_handler != SYNC_HANDLER_NONE)
@@ -31,6 +31,7 @@
 #include "access/slru.h"
 #include "access/subtrans.h"
 #include "access/transam.h"
+#include "access/xlog.h"
 #include "miscadmin.h"
 #include "pg_trace.h"
 #include "utils/guc_hooks.h"
@@ -73,6 +74,42 @@ static SlruCtlData SubTransCtlData;
 
 #define SubTransCtl  (&SubTransCtlData)
 
+/*
+ * Backend-local cache of SubTransGetTopmostTransaction() results.
+ *
+ * Once a snapshot is suboverflowed, XidInMVCCSnapshot() has to look up the
+ * topmost parent of every subtransaction XID it checks, and each step up the
+ * chain is a pg_subtrans lookup with a bank lock acquisition.  Scans
+ * repeatedly visit the same XIDs, e.g. after a loop that runs each row's
+ * work in its own subtransaction, so remember recent answers.
+ *
+ * A subtransaction's parent is recorded before its XID can appear anywhere
+ * else, and never changes afterwards, so a cached entry stays valid for as
+ * long as the XID can legitimately be asked about.  That's not true during
+ * recovery, where parents are only logged periodically, so we don't cache
+ * anything then.  The cache is direct-mapped on the low bits of the XID, so
+ * that the consecutive XIDs of a run of subtransactions don't collide.
+ *
+ * An entry is only valid as long as its XID can't have been recycled by
+ * wraparound, though.  So we empty the cache whenever TransactionXmin
+ * changes: while it stays put, every XID we can be asked about follows it
+ * and means the same transaction, while across a change we'd have no way to
+ * tell an old XID from a new one with the same value.  A long scan, which is
+ * what benefits from the cache, keeps the same TransactionXmin throughout.
+ */
+#define SUBTRANS_TOPMOST_CACHE_SIZE 1024
+
+typedef struct SubTransTopmostCacheEntry
+{
+	TransactionId xid;
+	TransactionId topmostXid;
+} SubTransTopmostCacheEntry;
+
+static SubTransTopmostCacheEntry topmostCache[SUBTRANS_TOPMOST_CACHE_SIZE];
+
+/* TransactionXmin the entries of topmostCache were computed with */
+static TransactionId topmostCacheXmin = InvalidTransactionId;
+
 
 static bool SubTransPagePrecedes(int64 page1, int64 page2);
 
@@ -161,17 +198,34 @@ SubTransGetParent(TransactionId xid)
 TransactionId
 SubTransGetTopmostTransaction(TransactionId xid)
 {
+	SubTransTopmostCacheEntry *entry;
 	TransactionId parentXid = xid,
 				previousXid = xid;
 
 	/* Can't ask about stuff that might not be around anymore */
 	Assert(TransactionIdFollowsOrEquals(xid, TransactionXmin));
 
+	if (topmostCacheXmin != TransactionXmin)
+	{
+		memset(topmostCache, 0, sizeof(topmostCache));
+		topmostCacheXmin = TransactionXmin;
+	}
+
+	entry = &topmostCache[xid % SUBTRANS_TOPMOST_CACHE_SIZE];
+	if (entry->xid == xid && TransactionIdIsValid(xid))
+		return entry->topmostXid;
+
 	while (TransactionIdIsValid(parentXid))
 	{
 		previousXid = parentXid;
 		if (TransactionIdPrecedes(parentXid, TransactionXmin))
-			break;
+		{
+			/*
+			 * The answer depends on TransactionXmin rather than on xid alone,
+			 * so don't cache it.
+			 */
+			return previousXid;
+		}
 		parentXid = SubTransGetParent(parentXid);
 
 		/*
@@ -186,6 +240,12 @@ SubTransGetTopmostTransaction(TransactionId xid)
 
 	Assert(TransactionIdIsValid(previousXid));
 
+	if (!RecoveryInProgress())
+	{
+		entry->xid = xid;
+		entry->topmostXid = previousXid;
+	}
+
 	return previousXid;
 }
 
@@ -25,14 +25,27 @@
 #include "utils/snapmgr.h"
 
 /*
- * Single-item cache for results of TransactionLogFetch.  It's worth having
- * such a cache because we frequently find ourselves repeatedly checking the
- * same XID, for example when scanning a table just after a bulk insert,
- * update, or delete.
+ * Small cache for results of TransactionLogFetch.  It's worth having such a
+ * cache because we frequently find ourselves repeatedly checking the same
+ * XID, for example when scanning a table just after a bulk insert, update,
+ * or delete.  Having a few entries rather than one keeps that effective when
+ * the data was written by several concurrent transactions, whose tuples are
+ * then interleaved on the pages.  The cache is direct-mapped on the low bits
+ * of the XID, which keeps lookups as cheap as with a single entry.
  */
-static TransactionId cachedFetchXid = InvalidTransactionId;
-static XidStatus cachedFetchXidStatus;
-static XLogRecPtr cachedCommitLSN;
+#define XID_STATUS_CACHE_SIZE	16
+
+typedef struct XidStatusCacheEntry
+{
+	TransactionId xid;
+	XidStatus	status;
+	XLogRecPtr	commitLSN;
+} XidStatusCacheEntry;
+
+static XidStatusCacheEntry xidStatusCache[XID_STATUS_CACHE_SIZE];
+
+#define XidStatusCacheSlot(xid) \
+	(&xidStatusCache[(xid) % XID_STATUS_CACHE_SIZE])
 
 /* Local functions */
 static XidStatus TransactionLogFetch(TransactionId transactionId);
@@ -51,15 +64,18 @@ static XidStatus TransactionLogFetch(TransactionId transactionId);
 static XidStatus
 TransactionLogFetch(TransactionId transactionId)
 {
+	XidStatusCacheEntry *entry = XidStatusCacheSlot(transactionId);
 	XidStatus	xidstatus;
 	XLogRecPtr	xidlsn;
 
 	/*
-	 * Before going to the commit log manager, check our single item cache to
-	 * see if we didn't just check the transaction status a moment ago.
+	 * Before going to the commit log manager, check our cache to see if we
+	 * didn't just check the transaction status a moment ago.  (The cache is
+	 * zero-initialized, and InvalidTransactionId is never stored in it.)
 	 */
-	if (TransactionIdEquals(transactionId, cachedFetchXid))
-		return cachedFetchXidStatus;
+	if (TransactionIdEquals(transactionId, entry->xid) &&
+		TransactionIdIsValid(transactionId))
+		return entry->status;
 
 	/*
 	 * Also, check to see if the transaction ID is a permanent one.
@@ -85,9 +101,9 @@ TransactionLogFetch(TransactionId transactionId)
 	if (xidstatus != TRANSACTION_STATUS_IN_PROGRESS &&
 		xidstatus != TRANSACTION_STATUS_SUB_COMMITTED)
 	{
-		cachedFetchXid = transactionId;
-		cachedFetchXidStatus = xidstatus;
-		cachedCommitLSN = xidlsn;
+		entry->xid = transactionId;
+		entry->status = xidstatus;
+		entry->commitLSN = xidlsn;
 	}
 
 	return xidstatus;
@@ -317,6 +333,7 @@ TransactionIdLatest(TransactionId mainxid,
 XLogRecPtr
 TransactionIdGetCommitLSN(TransactionId xid)
 {
+	XidStatusCacheEntry *entry = XidStatusCacheSlot(xid);
 	XLogRecPtr	result;
 
 	/*
@@ -325,8 +342,8 @@ TransactionIdGetCommitLSN(TransactionId xid)
 	 * checking TransactionLogFetch's cache will usually succeed and avoid an
 	 * extra trip to shared memory.
 	 */
-	if (TransactionIdEquals(xid, cachedFetchXid))
-		return cachedCommitLSN;
+	if (TransactionIdEquals(xid, entry->xid) && TransactionIdIsValid(xid))
+		return entry->commitLSN;
 
 	/* Special XIDs are always known committed */
 	if (!TransactionIdIsNormal(xid))
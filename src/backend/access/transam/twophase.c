@@ -14,7 +14,8 @@
  *		identifier (GID). The client assigns a GID to a postgres
  *		transaction with the PREPARE TRANSACTION command.
  *
- *		We keep all active global transactions in a shared memory array.
+ *		We keep all active global transactions in a shared memory array,
+ *		and index them by GID in a shared hash table.
  *		When the PREPARE TRANSACTION command is issued, the GID is
  *		reserved for the transaction in the array. This is done before
  *		a WAL entry is made, because the reservation checks for duplicate
@@ -103,6 +104,7 @@
 #include "storage/proc.h"
 #include "storage/procarray.h"
 #include "utils/builtins.h"
+#include "utils/hsearch.h"
 #include "utils/injection_point.h"
 #include "utils/memutils.h"
 #include "utils/timestamp.h"
@@ -188,6 +190,20 @@ typedef struct TwoPhaseStateData
 
 static TwoPhaseStateData *TwoPhaseState;
 
+/*
+ * Hash table mapping GIDs to the TwoPhaseState->prepXacts entries that use
+ * them, so that COMMIT/ROLLBACK PREPARED and PREPARE TRANSACTION don't need
+ * to scan the whole array.  Like TwoPhaseState, it is protected by
+ * TwoPhaseStateLock.  GIDs are unique among prepXacts entries.
+ */
+typedef struct GXactHashEntry
+{
+	char		gid[GIDSIZE];	/* hash key; must be first */
+	GlobalTransaction gxact;
+} GXactHashEntry;
+
+static HTAB *TwoPhaseGidHash;
+
 /*
  * Global transaction entry currently locked by us, if any.  Note that any
  * access to the entry pointed to by this variable must be protected by
@@ -220,7 +236,9 @@ static void RecordTransactionAbortPrepared(TransactionId xid,
 										   const char *gid);
 static void ProcessRecords(char *bufptr, FullTransactionId fxid,
 						   const TwoPhaseCallback callbacks[]);
+static void AddGXact(GlobalTransaction gxact);
 static void RemoveGXact(GlobalTransaction gxact);
+static GlobalTransaction FindGXactByGid(const char *gid);
 
 static void XlogReadTwoPhaseData(XLogRecPtr lsn, char **buf, int *len);
 static char *ProcessTwoPhaseBuffer(FullTransactionId fxid,
@@ -231,16 +249,21 @@ static void MarkAsPreparingGuts(GlobalTransaction gxact, FullTransactionId fxid,
 								Oid databaseid);
 static void RemoveTwoPhaseFile(FullTransactionId fxid, bool giveWarning);
 static void RecreateTwoPhaseFile(FullTransactionId fxid, void *content, int len);
+static Size TwoPhaseStateShmemSize(void);
 
 /*
  * Initialization of shared memory
  */
-Size
-TwoPhaseShmemSize(void)
+
+/*
+ * Size of the "Prepared Transaction Table" struct: the fixed struct, the
+ * array of pointers, and the GTD structs.
+ */
+static Size
+TwoPhaseStateShmemSize(void)
 {
 	Size		size;
 
-	/* Need the fixed struct, the array of pointers, and the GTD structs */
 	size = offsetof(TwoPhaseStateData, prepXacts);
 	size = add_size(size, mul_size(max_prepared_xacts,
 								   sizeof(GlobalTransaction)));
@@ -251,14 +274,37 @@ TwoPhaseShmemSize(void)
 	return size;
 }
 
+Size
+TwoPhaseShmemSize(void)
+{
+	Size		size;
+
+	size = TwoPhaseStateShmemSize();
+
+	/* And the GID hash table, which ShmemInitHash() allocates separately */
+	size = add_size(size, hash_estimate_size(Max(max_prepared_xacts, 1),
+											 sizeof(GXactHashEntry)));
+
+	return size;
+}
+
 void
 TwoPhaseShmemInit(void)
 {
 	bool		found;
+	HASHCTL		info;
 
 	TwoPhaseState = ShmemInitStruct("Prepared Transaction Table",
-									TwoPhaseShmemSize(),
+									TwoPhaseStateShmemSize(),
 									&found);
+
+	info.keysize = GIDSIZE;
+	info.entrysize = sizeof(GXactHashEntry);
+	TwoPhaseGidHash = ShmemInitHash("Prepared Transaction GID Lookup Table",
+									Max(max_prepared_xacts, 1),
+									Max(max_prepared_xacts, 1),
+									&info,
+									HASH_ELEM | HASH_STRINGS | HASH_FIXED_SIZE);
 	if (!IsUnderPostmaster)
 	{
 		GlobalTransaction gxacts;
@@ -362,7 +408,6 @@ MarkAsPreparing(FullTransactionId fxid, const char *gid,
 				TimestampTz prepared_at, Oid owner, Oid databaseid)
 {
 	GlobalTransaction gxact;
-	int			i;
 
 	if (strlen(gid) >= GIDSIZE)
 		ereport(ERROR,
@@ -387,17 +432,11 @@ MarkAsPreparing(FullTransactionId fxid, const char *gid,
 	LWLockAcquire(TwoPhaseStateLock, LW_EXCLUSIVE);
 
 	/* Check for conflicting GID */
-	for (i = 0; i < TwoPhaseState->numPrepXacts; i++)
-	{
-		gxact = TwoPhaseState->prepXacts[i];
-		if (strcmp(gxact->gid, gid) == 0)
-		{
-			ereport(ERROR,
-					(errcode(ERRCODE_DUPLICATE_OBJECT),
-					 errmsg("transaction identifier \"%s\" is already in use",
-							gid)));
-		}
-	}
+	if (FindGXactByGid(gid) != NULL)
+		ereport(ERROR,
+				(errcode(ERRCODE_DUPLICATE_OBJECT),
+				 errmsg("transaction identifier \"%s\" is already in use",
+						gid)));
 
 	/* Get a free gxact from the freelist */
 	if (TwoPhaseState->freeGXacts == NULL)
@@ -414,8 +453,7 @@ MarkAsPreparing(FullTransactionId fxid, const char *gid,
 	gxact->ondisk = false;
 
 	/* And insert it into the active array */
-	Assert(TwoPhaseState->numPrepXacts < max_prepared_xacts);
-	TwoPhaseState->prepXacts[TwoPhaseState->numPrepXacts++] = gxact;
+	AddGXact(gxact);
 
 	LWLockRelease(TwoPhaseStateLock);
 
@@ -555,7 +593,7 @@ MarkAsPrepared(GlobalTransaction gxact, bool lock_held)
 static GlobalTransaction
 LockGXact(const char *gid, Oid user)
 {
-	int			i;
+	GlobalTransaction gxact;
 
 	/* on first call, register the exit hook */
 	if (!twophaseExitRegistered)
@@ -566,17 +604,13 @@ LockGXact(const char *gid, Oid user)
 
 	LWLockAcquire(TwoPhaseStateLock, LW_EXCLUSIVE);
 
-	for (i = 0; i < TwoPhaseState->numPrepXacts; i++)
+	gxact = FindGXactByGid(gid);
+
+	/* Ignore not-yet-valid GIDs */
+	if (gxact != NULL && gxact->valid)
 	{
-		GlobalTransaction gxact = TwoPhaseState->prepXacts[i];
 		PGPROC	   *proc = GetPGProcByNumber(gxact->pgprocno);
 
-		/* Ignore not-yet-valid GIDs */
-		if (!gxact->valid)
-			continue;
-		if (strcmp(gxact->gid, gid) != 0)
-			continue;
-
 		/* Found it, but has someone else got it locked? */
 		if (gxact->locking_backend != INVALID_PROC_NUMBER)
 			ereport(ERROR,
@@ -622,6 +656,51 @@ LockGXact(const char *gid, Oid user)
 	return NULL;
 }
 
+/*
+ * FindGXactByGid
+ *		Return the prepXacts entry using the given GID, or NULL if none.
+ *
+ * Caller must hold TwoPhaseStateLock.  Note the entry might not be valid
+ * yet.
+ */
+static GlobalTransaction
+FindGXactByGid(const char *gid)
+{
+	GXactHashEntry *entry;
+
+	Assert(LWLockHeldByMe(TwoPhaseStateLock));
+
+	entry = (GXactHashEntry *) hash_search(TwoPhaseGidHash, gid,
+										   HASH_FIND, NULL);
+
+	return entry ? entry->gxact : NULL;
+}
+
+/*
+ * AddGXact
+ *		Insert a newly filled-in prepared transaction into the shared memory
+ *		array and the GID hash table.
+ */
+static void
+AddGXact(GlobalTransaction gxact)
+{
+	GXactHashEntry *entry;
+	bool		found;
+
+	Assert(LWLockHeldByMeInMode(TwoPhaseStateLock, LW_EXCLUSIVE));
+
+	/* There's room, since we got gxact from the freelist */
+	entry = (GXactHashEntry *) hash_search(TwoPhaseGidHash, gxact->gid,
+										   HASH_ENTER, &found);
+	if (found)
+		elog(ERROR, "transaction identifier \"%s\" is already in use",
+			 gxact->gid);
+	entry->gxact = gxact;
+
+	Assert(TwoPhaseState->numPrepXacts < max_prepared_xacts);
+	TwoPhaseState->prepXacts[TwoPhaseState->numPrepXacts++] = gxact;
+}
+
 /*
  * RemoveGXact
  *		Remove the prepared transaction from the shared memory array.
@@ -639,9 +718,13 @@ RemoveGXact(GlobalTransaction gxact)
 	{
 		if (gxact == TwoPhaseState->prepXacts[i])
 		{
-			/* remove from the active array */
+			/* remove from the active array and the GID hash table */
 			TwoPhaseState->numPrepXacts--;
 			TwoPhaseState->prepXacts[i] = TwoPhaseState->prepXacts[TwoPhaseState->numPrepXacts];
+			if (hash_search(TwoPhaseGidHash, gxact->gid,
+							HASH_REMOVE, NULL) == NULL)
+				elog(ERROR, "failed to find GID \"%s\" in hash table",
+					 gxact->gid);
 
 			/* and put it back in the freelist */
 			gxact->next = TwoPhaseState->freeGXacts;
@@ -2593,8 +2676,7 @@ PrepareRedoAdd(FullTransactionId fxid, char *buf,
 	strcpy(gxact->gid, gid);
 
 	/* And insert it into the active array */
-	Assert(TwoPhaseState->numPrepXacts < max_prepared_xacts);
-	TwoPhaseState->prepXacts[TwoPhaseState->numPrepXacts++] = gxact;
+	AddGXact(gxact);
 
 	if (origin_id != InvalidReplOriginId)
 	{
@@ -134,6 +134,8 @@ int			wal_sync_method = DEFAULT_WAL_SYNC_METHOD;
 int			wal_level = WAL_LEVEL_REPLICA;
 int			CommitDelay = 0;	/* precommit delay in microseconds */
 int			CommitSiblings = 5; /* # concurrent xacts needed to sleep */
+int			wal_writeback_after = 0;	/* in XLOG_BLCKSZ pages, 0 disables */
+bool		commit_delay_adaptive = false;
 int			wal_retrieve_retry_interval = 5000;
 int			max_slot_wal_keep_size_mb = -1;
 int			wal_decode_buffer_size = 512 * 1024;
@@ -146,11 +148,11 @@ bool		XLOG_DEBUG = false;
 int			wal_segment_size = DEFAULT_XLOG_SEG_SIZE;
 
 /*
- * Number of WAL insertion locks to use. A higher value allows more insertions
- * to happen concurrently, but adds some CPU overhead to flushing the WAL,
- * which needs to iterate all the locks.
+ * Number of WAL insertion locks to use (wal_insert_locks). A higher value
+ * allows more insertions to happen concurrently, but adds some CPU overhead
+ * to flushing the WAL, which needs to iterate all the locks.
  */
-#define NUM_XLOGINSERT_LOCKS  8
+int			wal_insert_locks = 8;
 
 /*
  * Max distance from last checkpoint, before triggering a new xlog-based
@@ -469,6 +471,20 @@ typedef struct XLogCtlData
 	pg_time_t	lastSegSwitchTime;
 	XLogRecPtr	lastSegSwitchLSN;
 
+	/*
+	 * State for commit_delay_adaptive.  flushRequests counts XLogFlush()
+	 * calls that found their record not yet flushed, and is only maintained
+	 * while commit_delay_adaptive is on.  The others are protected by
+	 * WALWriteLock: the running average of the time XLogWrite() takes when
+	 * called from XLogFlush(), and the time and flushRequests value at the
+	 * end of the last such flush, from which the arrival rate of flush
+	 * requests is computed.
+	 */
+	pg_atomic_uint64 flushRequests;
+	double		avgFlushUsec;
+	instr_time	lastFlushEnd;
+	uint64		lastFlushRequests;
+
 	/* These are accessed using atomics -- info_lck not needed */
 	pg_atomic_uint64 logInsertResult;	/* last byte + 1 inserted to buffers */
 	pg_atomic_uint64 logWriteResult;	/* last byte + 1 written out */
@@ -638,6 +654,12 @@ static int	openLogFile = -1;
 static XLogSegNo openLogSegNo = 0;
 static TimeLineID openLogTLI = 0;
 
+/*
+ * WAL before this position has been either flushed, or asked to be written
+ * back by the kernel on behalf of wal_writeback_after.
+ */
+static XLogRecPtr WritebackStartPtr = InvalidXLogRecPtr;
+
 /*
  * Local copies of equivalent fields in the control file.  When running
  * crash recovery, LocalMinRecoveryPoint is set to InvalidXLogRecPtr as we
@@ -673,6 +695,8 @@ static void KeepLogSeg(XLogRecPtr recptr, XLogSegNo *logSegNo);
 static void AdvanceXLInsertBuffer(XLogRecPtr upto, TimeLineID tli,
 								  bool opportunistic);
 static void XLogWrite(XLogwrtRqst WriteRqst, TimeLineID tli, bool flexible);
+static int	AdaptiveCommitDelay(void);
+static void XLogStartWriteback(void);
 static bool InstallXLogFileSegment(XLogSegNo *segno, char *tmppath,
 								   bool find_free, XLogSegNo max_segno,
 								   TimeLineID tli);
@@ -804,7 +828,7 @@ XLogInsertRecord(XLogRecData *rdata,
 	 * inserter acquires an insertion lock. In addition to just indicating that
 	 * an insertion is in progress, the lock tells others how far the inserter
 	 * has progressed. There is a small fixed number of insertion locks,
-	 * determined by NUM_XLOGINSERT_LOCKS. When an inserter crosses a page
+	 * determined by wal_insert_locks. When an inserter crosses a page
 	 * boundary, it updates the value stored in the lock to the how far it has
 	 * inserted, to allow the previous buffer to be flushed.
 	 *
@@ -1392,7 +1416,7 @@ WALInsertLockAcquire(void)
 	static int	lockToTry = -1;
 
 	if (lockToTry == -1)
-		lockToTry = MyProcNumber % NUM_XLOGINSERT_LOCKS;
+		lockToTry = MyProcNumber % wal_insert_locks;
 	MyLockNo = lockToTry;
 
 	/*
@@ -1410,7 +1434,7 @@ WALInsertLockAcquire(void)
 		 * than locks, it still helps to distribute the inserters evenly
 		 * across the locks.
 		 */
-		lockToTry = (lockToTry + 1) % NUM_XLOGINSERT_LOCKS;
+		lockToTry = (lockToTry + 1) % wal_insert_locks;
 	}
 }
 
@@ -1428,7 +1452,7 @@ WALInsertLockAcquireExclusive(void)
 	 * indicator is set to 0xFFFFFFFFFFFFFFFF, which is higher than any real
 	 * XLogRecPtr value, to make sure that no-one blocks waiting on those.
 	 */
-	for (i = 0; i < NUM_XLOGINSERT_LOCKS - 1; i++)
+	for (i = 0; i < wal_insert_locks - 1; i++)
 	{
 		LWLockAcquire(&WALInsertLocks[i].l.lock, LW_EXCLUSIVE);
 		LWLockUpdateVar(&WALInsertLocks[i].l.lock,
@@ -1454,7 +1478,7 @@ WALInsertLockRelease(void)
 	{
 		int			i;
 
-		for (i = 0; i < NUM_XLOGINSERT_LOCKS; i++)
+		for (i = 0; i < wal_insert_locks; i++)
 			LWLockReleaseClearVar(&WALInsertLocks[i].l.lock,
 								  &WALInsertLocks[i].l.insertingAt,
 								  0);
@@ -1482,8 +1506,8 @@ WALInsertLockUpdateInsertingAt(XLogRecPtr insertingAt)
 		 * We use the last lock to mark our actual position, see comments in
 		 * WALInsertLockAcquireExclusive.
 		 */
-		LWLockUpdateVar(&WALInsertLocks[NUM_XLOGINSERT_LOCKS - 1].l.lock,
-						&WALInsertLocks[NUM_XLOGINSERT_LOCKS - 1].l.insertingAt,
+		LWLockUpdateVar(&WALInsertLocks[wal_insert_locks - 1].l.lock,
+						&WALInsertLocks[wal_insert_locks - 1].l.insertingAt,
 						insertingAt);
 	}
 	else
@@ -1559,7 +1583,7 @@ WaitXLogInsertionsToFinish(XLogRecPtr upto)
 	 * out for any insertion that's still in progress.
 	 */
 	finishedUpto = reservedUpto;
-	for (i = 0; i < NUM_XLOGINSERT_LOCKS; i++)
+	for (i = 0; i < wal_insert_locks; i++)
 	{
 		XLogRecPtr	insertingat = InvalidXLogRecPtr;
 
@@ -2506,6 +2530,20 @@ XLogWrite(XLogwrtRqst WriteRqst, TimeLineID tli, bool flexible)
 
 	Assert(npages == 0);
 
+	/*
+	 * If we're not going to flush what we just wrote, consider asking the
+	 * kernel to start writing it back to storage.  That way the device works
+	 * on it while we go on, and the eventual flush has less left to do.
+	 * Only whole pages in the current segment are considered, as a partial
+	 * page is going to be written again.  With the open_* sync methods the
+	 * writes are synchronous already.
+	 */
+	if (wal_writeback_after > 0 && openLogFile >= 0 &&
+		LogwrtResult.Flush >= WriteRqst.Flush &&
+		wal_sync_method != WAL_SYNC_METHOD_OPEN &&
+		wal_sync_method != WAL_SYNC_METHOD_OPEN_DSYNC)
+		XLogStartWriteback();
+
 	/*
 	 * If asked to flush, do so
 	 */
@@ -2768,6 +2806,8 @@ XLogFlush(XLogRecPtr record)
 	XLogRecPtr	WriteRqstPtr;
 	XLogwrtRqst WriteRqst;
 	TimeLineID	insertTLI = XLogCtl->InsertTimeLineID;
+	instr_time	flush_start;
+	int			delay;
 
 	/*
 	 * During REDO, we are reading not writing WAL.  Therefore, instead of
@@ -2786,6 +2826,10 @@ XLogFlush(XLogRecPtr record)
 	if (record <= LogwrtResult.Flush)
 		return;
 
+	pgWalUsage.wal_flush_requests++;
+	if (commit_delay_adaptive)
+		pg_atomic_fetch_add_u64(&XLogCtl->flushRequests, 1);
+
 #ifdef WAL_DEBUG
 	if (XLOG_DEBUG)
 		elog(LOG, "xlog flush request %X/%08X; write %X/%08X; flush %X/%08X",
@@ -2861,14 +2905,18 @@ XLogFlush(XLogRecPtr record)
 		 * followers; this can significantly improve transaction throughput,
 		 * at the risk of increasing transaction latency.
 		 *
+		 * With commit_delay_adaptive, the delay is computed from the recent
+		 * flush duration and rate of flush requests instead.
+		 *
 		 * We do not sleep if enableFsync is not turned on, nor if there are
 		 * fewer than CommitSiblings other backends with active transactions.
 		 */
-		if (CommitDelay > 0 && enableFsync &&
+		delay = commit_delay_adaptive ? AdaptiveCommitDelay() : CommitDelay;
+		if (delay > 0 && enableFsync &&
 			MinimumActiveBackends(CommitSiblings))
 		{
 			pgstat_report_wait_start(WAIT_EVENT_COMMIT_DELAY);
-			pg_usleep(CommitDelay);
+			pg_usleep(delay);
 			pgstat_report_wait_end();
 
 			/*
@@ -2888,7 +2936,27 @@ XLogFlush(XLogRecPtr record)
 		WriteRqst.Write = insertpos;
 		WriteRqst.Flush = insertpos;
 
+		if (commit_delay_adaptive)
+			INSTR_TIME_SET_CURRENT(flush_start);
+
 		XLogWrite(WriteRqst, insertTLI, false);
+		pgWalUsage.wal_group_flushes++;
+
+		if (commit_delay_adaptive)
+		{
+			instr_time	flush_end;
+			double		flush_usec;
+
+			INSTR_TIME_SET_CURRENT(flush_end);
+			flush_usec = INSTR_TIME_GET_MICROSEC(flush_end) -
+				INSTR_TIME_GET_MICROSEC(flush_start);
+
+			/* exponential moving average, weighting recent flushes */
+			XLogCtl->avgFlushUsec += (flush_usec - XLogCtl->avgFlushUsec) / 8;
+			XLogCtl->lastFlushEnd = flush_end;
+			XLogCtl->lastFlushRequests =
+				pg_atomic_read_u64(&XLogCtl->flushRequests);
+		}
 
 		LWLockRelease(WALWriteLock);
 		/* done */
@@ -2943,6 +3011,81 @@ XLogFlush(XLogRecPtr record)
 	Assert(!XLogNeedsFlush(record));
 }
 
+/*
+ * Ask the kernel to write back the WAL that XLogWrite() has written to the
+ * open segment but not flushed, once there is at least wal_writeback_after
+ * pages of it.
+ */
+static void
+XLogStartWriteback(void)
+{
+	XLogRecPtr	segstart;
+	XLogRecPtr	startptr;
+	XLogRecPtr	endptr;
+
+	XLogSegNoOffsetToRecPtr(openLogSegNo, 0, wal_segment_size, segstart);
+
+	startptr = Max(WritebackStartPtr, LogwrtResult.Flush);
+	startptr = Max(startptr, segstart);
+	endptr = LogwrtResult.Write - LogwrtResult.Write % XLOG_BLCKSZ;
+	endptr = Min(endptr, segstart + wal_segment_size);
+
+	if (endptr <= startptr ||
+		endptr - startptr < (uint64) wal_writeback_after * XLOG_BLCKSZ)
+		return;
+
+	pg_flush_data(openLogFile,
+				  XLogSegmentOffset(startptr, wal_segment_size),
+				  endptr - startptr);
+
+	WritebackStartPtr = endptr;
+}
+
+/*
+ * Compute the delay for commit_delay_adaptive, in microseconds.
+ *
+ * The caller must hold WALWriteLock, and is about to flush WAL on behalf of
+ * everyone waiting for it.  Waiting before the flush is only worthwhile if
+ * other backends are likely to request a flush in the meantime, that is, if
+ * at the rate flush requests have been arriving since the previous flush
+ * ended, at least one more is expected within a flush's duration.  We then
+ * wait half the average flush duration, which bounds the added latency while
+ * letting a good share of the expected arrivals join this flush.  A nonzero
+ * commit_delay additionally caps the delay.
+ */
+static int
+AdaptiveCommitDelay(void)
+{
+	instr_time	now;
+	double		elapsed_usec;
+	uint64		arrivals;
+	double		expected;
+	double		delay;
+
+	if (XLogCtl->avgFlushUsec <= 0 || INSTR_TIME_IS_ZERO(XLogCtl->lastFlushEnd))
+		return 0;
+
+	INSTR_TIME_SET_CURRENT(now);
+	elapsed_usec = INSTR_TIME_GET_MICROSEC(now) -
+		INSTR_TIME_GET_MICROSEC(XLogCtl->lastFlushEnd);
+	arrivals = pg_atomic_read_u64(&XLogCtl->flushRequests) -
+		XLogCtl->lastFlushRequests;
+
+	if (elapsed_usec <= 0 || arrivals == 0)
+		return 0;
+
+	expected = arrivals / elapsed_usec * XLogCtl->avgFlushUsec;
+	if (expected < 1.0)
+		return 0;
+
+	/* same limit as commit_delay itself */
+	delay = Min(XLogCtl->avgFlushUsec / 2, 100000);
+	if (CommitDelay > 0)
+		delay = Min(delay, CommitDelay);
+
+	return (int) delay;
+}
+
 /*
  * Write & flush xlog, but without specifying exactly where to.
  *
@@ -4973,7 +5116,7 @@ XLOGShmemSize(void)
 	size = sizeof(XLogCtlData);
 
 	/* WAL insertion locks, plus alignment */
-	size = add_size(size, mul_size(sizeof(WALInsertLockPadded), NUM_XLOGINSERT_LOCKS + 1));
+	size = add_size(size, mul_size(sizeof(WALInsertLockPadded), wal_insert_locks + 1));
 	/* xlblocks array */
 	size = add_size(size, mul_size(sizeof(pg_atomic_uint64), XLOGbuffers));
 	/* extra alignment padding for XLOG I/O buffers */
@@ -5066,9 +5209,9 @@ XLOGShmemInit(void)
 		((uintptr_t) allocptr) % sizeof(WALInsertLockPadded);
 	WALInsertLocks = XLogCtl->Insert.WALInsertLocks =
 		(WALInsertLockPadded *) allocptr;
-	allocptr += sizeof(WALInsertLockPadded) * NUM_XLOGINSERT_LOCKS;
+	allocptr += sizeof(WALInsertLockPadded) * wal_insert_locks;
 
-	for (i = 0; i < NUM_XLOGINSERT_LOCKS; i++)
+	for (i = 0; i < wal_insert_locks; i++)
 	{
 		LWLockInitialize(&WALInsertLocks[i].l.lock, LWTRANCHE_WAL_INSERT);
 		pg_atomic_init_u64(&WALInsertLocks[i].l.insertingAt, InvalidXLogRecPtr);
@@ -5099,6 +5242,7 @@ XLOGShmemInit(void)
 	pg_atomic_init_u64(&XLogCtl->logWriteResult, InvalidXLogRecPtr);
 	pg_atomic_init_u64(&XLogCtl->logFlushResult, InvalidXLogRecPtr);
 	pg_atomic_init_u64(&XLogCtl->unloggedLSN, InvalidXLogRecPtr);
+	pg_atomic_init_u64(&XLogCtl->flushRequests, 0);
 }
 
 /*
@@ -6667,7 +6811,7 @@ GetLastImportantRecPtr(void)
 	XLogRecPtr	res = InvalidXLogRecPtr;
 	int			i;
 
-	for (i = 0; i < NUM_XLOGINSERT_LOCKS; i++)
+	for (i = 0; i < wal_insert_locks; i++)
 	{
 		XLogRecPtr	last_important;
 
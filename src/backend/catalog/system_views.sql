@@ -975,6 +975,8 @@ CREATE VIEW pg_stat_slru AS
             s.blks_exists,
             s.flushes,
             s.truncates,
+            s.blk_read_time,
+            s.blk_write_time,
             s.stats_reset
     FROM pg_stat_get_slru() s;
 
@@ -1254,6 +1256,8 @@ CREATE VIEW pg_stat_wal AS
         w.wal_bytes,
         w.wal_fpi_bytes,
         w.wal_buffers_full,
+        w.wal_flush_requests,
+        w.wal_group_flushes,
         w.stats_reset
     FROM pg_stat_get_wal() w;
 
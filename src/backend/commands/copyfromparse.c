@@ -72,7 +72,9 @@
 #include "miscadmin.h"
 #include "pgstat.h"
 #include "port/pg_bswap.h"
+#include "port/simd.h"
 #include "utils/builtins.h"
+#include "utils/fmgroids.h"
 #include "utils/rel.h"
 
 #define ISOCTAL(c) (((c) >= '0') && ((c) <= '7'))
@@ -392,6 +394,23 @@ CopyGetInt16(CopyFromState cstate, int16 *val)
 	return true;
 }
 
+/*
+ * CopyGetInt64 reads an int64 that appears in network byte order
+ */
+static inline bool
+CopyGetInt64(CopyFromState cstate, int64 *val)
+{
+	uint64		buf;
+
+	if (CopyReadBinaryData(cstate, (char *) &buf, sizeof(buf)) != sizeof(buf))
+	{
+		*val = 0;				/* suppress compiler warning */
+		return false;
+	}
+	*val = (int64) pg_ntoh64(buf);
+	return true;
+}
+
 
 /*
  * Perform encoding conversion on data in 'raw_buf', writing the converted
@@ -1402,6 +1421,33 @@ CopyReadLineText(CopyFromState cstate, bool is_csv)
 			need_data = false;
 		}
 
+		/*
+		 * Most bytes are not interesting to this loop, so skip over them a
+		 * vector at a time as long as the next chunk doesn't contain any
+		 * newline, carriage return, or (depending on the mode) backslash,
+		 * quote or escape character.  Any ordinary character ends an
+		 * escape-escape sequence, per the CSV logic below.
+		 */
+		while (input_buf_ptr + sizeof(Vector8) < copy_buf_len)
+		{
+			Vector8		chunk;
+
+			vector8_load(&chunk, (const uint8 *) &copy_input_buf[input_buf_ptr]);
+			if (vector8_has(chunk, '\n') || vector8_has(chunk, '\r'))
+				break;
+			if (is_csv)
+			{
+				if (vector8_has(chunk, quotec) ||
+					(escapec != '\0' && vector8_has(chunk, escapec)))
+					break;
+				last_was_esc = false;
+			}
+			else if (vector8_has(chunk, '\\'))
+				break;
+
+			input_buf_ptr += sizeof(Vector8);
+		}
+
 		/* OK to fetch a character */
 		prev_raw_ptr = input_buf_ptr;
 		c = copy_input_buf[input_buf_ptr++];
@@ -2114,6 +2160,58 @@ CopyReadBinaryAttribute(CopyFromState cstate, FmgrInfo *flinfo,
 				(errcode(ERRCODE_BAD_COPY_FILE_FORMAT),
 				 errmsg("invalid field size")));
 
+	/*
+	 * The binary format of the common integer types is just the value in
+	 * network byte order, so read those directly instead of going through
+	 * attribute_buf and the receive function.  If the field size is wrong,
+	 * let the receive function below complain about it.
+	 */
+	switch (flinfo->fn_oid)
+	{
+		case F_INT2RECV:
+			if (fld_size == sizeof(int16))
+			{
+				int16		val;
+
+				if (!CopyGetInt16(cstate, &val))
+					ereport(ERROR,
+							(errcode(ERRCODE_BAD_COPY_FILE_FORMAT),
+							 errmsg("unexpected EOF in COPY data")));
+				*isnull = false;
+				return Int16GetDatum(val);
+			}
+			break;
+		case F_INT4RECV:
+		case F_OIDRECV:
+			if (fld_size == sizeof(int32))
+			{
+				int32		val;
+
+				if (!CopyGetInt32(cstate, &val))
+					ereport(ERROR,
+							(errcode(ERRCODE_BAD_COPY_FILE_FORMAT),
+							 errmsg("unexpected EOF in COPY data")));
+				*isnull = false;
+				if (flinfo->fn_oid == F_OIDRECV)
+					return ObjectIdGetDatum((Oid) val);
+				return Int32GetDatum(val);
+			}
+			break;
+		case F_INT8RECV:
+			if (fld_size == sizeof(int64))
+			{
+				int64		val;
+
+				if (!CopyGetInt64(cstate, &val))
+					ereport(ERROR,
+							(errcode(ERRCODE_BAD_COPY_FILE_FORMAT),
+							 errmsg("unexpected EOF in COPY data")));
+				*isnull = false;
+				return Int64GetDatum(val);
+			}
+			break;
+	}
+
 	/* reset attribute_buf to empty, and load raw data in it */
 	resetStringInfo(&cstate->attribute_buf);
 
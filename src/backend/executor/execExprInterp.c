@@ -66,11 +66,13 @@
 #include "nodes/miscnodes.h"
 #include "nodes/nodeFuncs.h"
 #include "pgstat.h"
+#include "port/pg_lfind.h"
 #include "utils/array.h"
 #include "utils/builtins.h"
 #include "utils/date.h"
 #include "utils/datum.h"
 #include "utils/expandedrecord.h"
+#include "utils/fmgroids.h"
 #include "utils/json.h"
 #include "utils/jsonfuncs.h"
 #include "utils/jsonpath.h"
@@ -162,6 +164,8 @@ static Datum ExecJustAssignOuterVar(ExprState *state, ExprContext *econtext, boo
 static Datum ExecJustAssignScanVar(ExprState *state, ExprContext *econtext, bool *isnull);
 static Datum ExecJustApplyFuncToCase(ExprState *state, ExprContext *econtext, bool *isnull);
 static Datum ExecJustConst(ExprState *state, ExprContext *econtext, bool *isnull);
+static Datum ExecJustScanVarConstQual(ExprState *state, ExprContext *econtext, bool *isnull);
+static Datum ExecJustScanVarConstQual2(ExprState *state, ExprContext *econtext, bool *isnull);
 static Datum ExecJustInnerVarVirt(ExprState *state, ExprContext *econtext, bool *isnull);
 static Datum ExecJustOuterVarVirt(ExprState *state, ExprContext *econtext, bool *isnull);
 static Datum ExecJustScanVarVirt(ExprState *state, ExprContext *econtext, bool *isnull);
@@ -280,7 +284,27 @@ ExecReadyInterpretedExpr(ExprState *state)
 	 * the full interpreter is a measurable overhead for these, and these
 	 * patterns occur often enough to be worth optimizing.
 	 */
-	if (state->steps_len == 5)
+	if (state->steps_len == 8)
+	{
+		ExprEvalStep *steps = state->steps;
+
+		/*
+		 * Two ANDed "scan Var op Const" quals, e.g. a range condition.  As
+		 * in the single-clause case below, the Consts don't get steps.
+		 */
+		if (steps[0].opcode == EEOP_SCAN_FETCHSOME &&
+			steps[1].opcode == EEOP_SCAN_VAR &&
+			steps[2].opcode == EEOP_FUNCEXPR_STRICT_2 &&
+			steps[3].opcode == EEOP_QUAL &&
+			steps[4].opcode == EEOP_SCAN_VAR &&
+			steps[5].opcode == EEOP_FUNCEXPR_STRICT_2 &&
+			steps[6].opcode == EEOP_QUAL)
+		{
+			state->evalfunc_private = ExecJustScanVarConstQual2;
+			return;
+		}
+	}
+	else if (state->steps_len == 5)
 	{
 		ExprEvalOp	step0 = state->steps[0].opcode;
 		ExprEvalOp	step1 = state->steps[1].opcode;
@@ -295,6 +319,21 @@ ExecReadyInterpretedExpr(ExprState *state)
 			state->evalfunc_private = (void *) ExecJustHashInnerVarWithIV;
 			return;
 		}
+
+		/*
+		 * A single "scan Var op Const" qual, as is typical for filtered
+		 * sequential scans feeding an aggregate.  ExecInitFunc() stores a
+		 * Const argument directly into the function's argument array, so
+		 * only the Var gets a step of its own, whichever side it is on.
+		 */
+		else if (step0 == EEOP_SCAN_FETCHSOME &&
+				 step1 == EEOP_SCAN_VAR &&
+				 step2 == EEOP_FUNCEXPR_STRICT_2 &&
+				 step3 == EEOP_QUAL)
+		{
+			state->evalfunc_private = ExecJustScanVarConstQual;
+			return;
+		}
 	}
 	else if (state->steps_len == 4)
 	{
@@ -2674,6 +2713,81 @@ ExecJustConst(ExprState *state, ExprContext *econtext, bool *isnull)
 	return op->d.constval.value;
 }
 
+/*
+ * Evaluate one "scan Var op Const" clause of a qual, that is a strict
+ * two-argument function applied to a scan Var and a Const, e.g.
+ * "col > 42" or "42 < col".  The clause's Var is step 'varstep', and the
+ * function is the step right after it.  The Var step stores directly into
+ * the function's argument array, as it would in ExecInterpExpr(), while the
+ * Const was put into that array once and for all by ExecInitFunc().
+ * Returns the clause's value, with NULL treated as false as in EEOP_QUAL.
+ */
+static pg_attribute_always_inline bool
+ExecJustVarConstClause(ExprState *state, TupleTableSlot *slot, int varstep)
+{
+	ExprEvalStep *varop = &state->steps[varstep];
+	ExprEvalStep *funcop = &state->steps[varstep + 1];
+	FunctionCallInfo fcinfo = funcop->d.func.fcinfo_data;
+	NullableDatum *args = fcinfo->args;
+	Datum		d;
+
+	/*
+	 * As in ExecJustVarImpl, slot_getattr() takes care of the FETCHSOME step
+	 * and of checking that the attnum is in range.
+	 */
+	*varop->resvalue = slot_getattr(slot, varop->d.var.attnum + 1,
+									varop->resnull);
+
+	/* strict function, so check for NULL args */
+	if (args[0].isnull || args[1].isnull)
+		return false;
+
+	fcinfo->isnull = false;
+	d = funcop->d.func.fn_addr(fcinfo);
+
+	return !fcinfo->isnull && DatumGetBool(d);
+}
+
+/*
+ * Evaluate a qual consisting of a single "scan Var op Const" clause, e.g.
+ * "WHERE col > 42", avoiding the interpreter startup and dispatch over its
+ * five steps.
+ */
+static Datum
+ExecJustScanVarConstQual(ExprState *state, ExprContext *econtext, bool *isnull)
+{
+	TupleTableSlot *slot = econtext->ecxt_scantuple;
+
+	CheckOpSlotCompatibility(&state->steps[0], slot);
+
+	/* a qual never yields NULL */
+	*isnull = false;
+
+	return BoolGetDatum(ExecJustVarConstClause(state, slot, 1));
+}
+
+/*
+ * Evaluate two ANDed "scan Var op Const" clauses, as in "WHERE col >= 10
+ * AND col < 20", with the same shortcut as ExecJustScanVarConstQual.  The
+ * first clause is steps 1 to 3 and the second steps 4 to 6; each may have
+ * its Var and Const in either order.
+ */
+static Datum
+ExecJustScanVarConstQual2(ExprState *state, ExprContext *econtext, bool *isnull)
+{
+	TupleTableSlot *slot = econtext->ecxt_scantuple;
+
+	CheckOpSlotCompatibility(&state->steps[0], slot);
+
+	/* a qual never yields NULL */
+	*isnull = false;
+
+	if (!ExecJustVarConstClause(state, slot, 1))
+		return BoolGetDatum(false);
+
+	return BoolGetDatum(ExecJustVarConstClause(state, slot, 4));
+}
+
 /* implementation of ExecJust(Inner|Outer|Scan)VarVirt */
 static pg_attribute_always_inline Datum
 ExecJustVarVirtImpl(ExprState *state, TupleTableSlot *slot, bool *isnull)
@@ -4089,6 +4203,30 @@ ExecEvalScalarArrayOp(ExprState *state, ExprEvalStep *op)
 	typalign = op->d.scalararrayop.typalign;
 	typalignby = typalign_to_alignby(typalign);
 
+	/*
+	 * For "int4/oid = ANY" and "int4/oid <> ALL" over an array without
+	 * NULLs, the operator is plain bitwise equality of 4-byte values, so we
+	 * can search the array's data with pg_lfind32() (which uses SIMD where
+	 * available) instead of calling the operator once per element.  The
+	 * scalar can't be NULL here since these functions are strict.
+	 */
+	if (typlen == sizeof(uint32) && !ARR_HASNULL(arr))
+	{
+		Oid			fn_oid = op->d.scalararrayop.finfo->fn_oid;
+
+		if ((useOr && (fn_oid == F_INT4EQ || fn_oid == F_OIDEQ)) ||
+			(!useOr && (fn_oid == F_INT4NE || fn_oid == F_OIDNE)))
+		{
+			bool		found;
+
+			found = pg_lfind32(DatumGetUInt32(fcinfo->args[0].value),
+							   (uint32 *) ARR_DATA_PTR(arr), nitems);
+			*op->resvalue = BoolGetDatum(found == useOr);
+			*op->resnull = false;
+			return;
+		}
+	}
+
 	/* Initialize result appropriately depending on useOr */
 	result = BoolGetDatum(!useOr);
 	resultnull = false;
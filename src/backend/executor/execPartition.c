@@ -2234,9 +2234,12 @@ CreatePartitionPruneState(EState *estate, PartitionPruneInfo *pruneinfo,
 			 *
 			 * The set of partitions that exist now might not be the same that
 			 * existed when the plan was made.  The normal case is that it is;
-			 * optimize for that case with a quick comparison, and just copy
-			 * the subplan_map and make subpart_map, leafpart_rti_map point to
-			 * the ones in PruneInfo.
+			 * optimize for that case with a quick comparison, and just make
+			 * all three maps point to the ones in PruneInfo.  (That saves
+			 * copying an array as long as the partition count on every
+			 * execution of a cached plan.  InitExecPartitionPruneContexts
+			 * builds a new subplan_map instead of scribbling on the shared
+			 * one.)
 			 *
 			 * For the case where they aren't identical, we could have more
 			 * partitions on either side; or even exactly the same number of
@@ -2248,16 +2251,14 @@ CreatePartitionPruneState(EState *estate, PartitionPruneInfo *pruneinfo,
 			 * arrays are in partition bounds order.
 			 */
 			pprune->nparts = partdesc->nparts;
-			pprune->subplan_map = palloc_array(int, partdesc->nparts);
 
 			if (partdesc->nparts == pinfo->nparts &&
 				memcmp(partdesc->oids, pinfo->relid_map,
 					   sizeof(int) * partdesc->nparts) == 0)
 			{
+				pprune->subplan_map = pinfo->subplan_map;
 				pprune->subpart_map = pinfo->subpart_map;
 				pprune->leafpart_rti_map = pinfo->leafpart_rti_map;
-				memcpy(pprune->subplan_map, pinfo->subplan_map,
-					   sizeof(int) * pinfo->nparts);
 			}
 			else
 			{
@@ -2275,6 +2276,7 @@ CreatePartitionPruneState(EState *estate, PartitionPruneInfo *pruneinfo,
 				 * attached.  Cope with that by creating a map that skips any
 				 * mismatches.
 				 */
+				pprune->subplan_map = palloc_array(int, partdesc->nparts);
 				pprune->subpart_map = palloc_array(int, partdesc->nparts);
 				pprune->leafpart_rti_map = palloc_array(int, partdesc->nparts);
 
@@ -2565,6 +2567,7 @@ InitExecPartitionPruneContexts(PartitionPruneState *prunestate,
 		{
 			PartitionedRelPruningData *pprune = &prunedata->partrelprunedata[j];
 			int			nparts = pprune->nparts;
+			int		   *old_subplan_map;
 			int			k;
 
 			/* Initialize PartitionPruneContext for exec pruning, if needed. */
@@ -2590,15 +2593,24 @@ InitExecPartitionPruneContexts(PartitionPruneState *prunestate,
 			if (!fix_subplan_map)
 				continue;
 
+			/*
+			 * subplan_map may point into the plan, which mustn't be modified,
+			 * so build the new map in a fresh array.
+			 */
+			old_subplan_map = pprune->subplan_map;
+			pprune->subplan_map = palloc_array(int, nparts);
+
 			/* We just rebuild present_parts from scratch */
 			bms_free(pprune->present_parts);
 			pprune->present_parts = NULL;
 
 			for (k = 0; k < nparts; k++)
 			{
-				int			oldidx = pprune->subplan_map[k];
+				int			oldidx = old_subplan_map[k];
 				int			subidx;
 
+				pprune->subplan_map[k] = oldidx;
+
 				/*
 				 * If this partition existed as a subplan then change the old
 				 * subplan index to the new subplan index.  The new index may
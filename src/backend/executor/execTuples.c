@@ -64,6 +64,7 @@
 #include "catalog/pg_type.h"
 #include "funcapi.h"
 #include "nodes/nodeFuncs.h"
+#include "port/pg_bitutils.h"
 #include "storage/bufmgr.h"
 #include "utils/builtins.h"
 #include "utils/expandeddatum.h"
@@ -1104,6 +1105,33 @@ slot_deform_heap_tuple_internal(TupleTableSlot *slot, HeapTuple tuple,
 	return natts;
 }
 
+/*
+ * heap_first_null_attnum
+ *		Return the number of the first NULL attribute at or after 'attnum'
+ *		in the null bitmap 'bp', or 'natts' if there is none before that.
+ *
+ * This examines the bitmap a byte at a time rather than testing each
+ * attribute's bit, which lets callers deform the leading non-NULL attributes
+ * without any per-attribute NULL checks.
+ */
+static inline int
+heap_first_null_attnum(bits8 *bp, int attnum, int natts)
+{
+	while (attnum < natts)
+	{
+		/* a clear bit in the bitmap means the attribute is NULL */
+		uint32		nulls = (uint8) ~bp[attnum >> 3];
+
+		nulls >>= (attnum & 7);
+		if (nulls != 0)
+			return Min(attnum + pg_rightmost_one_pos32(nulls), natts);
+
+		attnum = ((attnum >> 3) + 1) << 3;
+	}
+
+	return natts;
+}
+
 /*
  * slot_deform_heap_tuple
  *		Given a TupleTableSlot, extract data from the slot's physical tuple
@@ -1172,14 +1200,35 @@ slot_deform_heap_tuple(TupleTableSlot *slot, HeapTuple tuple, uint32 *offp,
 													 &off,
 													 &slow);
 		else
-			attnum = slot_deform_heap_tuple_internal(slot,
-													 tuple,
-													 attnum,
-													 natts,
-													 false, /* slow */
-													 true,	/* hasnulls */
-													 &off,
-													 &slow);
+		{
+			/*
+			 * Deform the attributes before the first NULL one without NULL
+			 * checks, then carry on with them; the NULL will switch us to
+			 * slow mode.
+			 */
+			int			firstnull;
+
+			firstnull = heap_first_null_attnum(tuple->t_data->t_bits,
+											   attnum, natts);
+			if (firstnull > attnum)
+				attnum = slot_deform_heap_tuple_internal(slot,
+														 tuple,
+														 attnum,
+														 firstnull,
+														 false, /* slow */
+														 false, /* hasnulls */
+														 &off,
+														 &slow);
+			if (!slow && attnum < natts)
+				attnum = slot_deform_heap_tuple_internal(slot,
+														 tuple,
+														 attnum,
+														 natts,
+														 false, /* slow */
+														 true,	/* hasnulls */
+														 &off,
+														 &slow);
+		}
 	}
 
 	/* If there's still work to do then we must be in slow mode */
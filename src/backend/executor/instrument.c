@@ -283,6 +283,8 @@ WalUsageAdd(WalUsage *dst, WalUsage *add)
 	dst->wal_fpi += add->wal_fpi;
 	dst->wal_fpi_bytes += add->wal_fpi_bytes;
 	dst->wal_buffers_full += add->wal_buffers_full;
+	dst->wal_flush_requests += add->wal_flush_requests;
+	dst->wal_group_flushes += add->wal_group_flushes;
 }
 
 void
@@ -293,4 +295,6 @@ WalUsageAccumDiff(WalUsage *dst, const WalUsage *add, const WalUsage *sub)
 	dst->wal_fpi += add->wal_fpi - sub->wal_fpi;
 	dst->wal_fpi_bytes += add->wal_fpi_bytes - sub->wal_fpi_bytes;
 	dst->wal_buffers_full += add->wal_buffers_full - sub->wal_buffers_full;
+	dst->wal_flush_requests += add->wal_flush_requests - sub->wal_flush_requests;
+	dst->wal_group_flushes += add->wal_group_flushes - sub->wal_group_flushes;
 }
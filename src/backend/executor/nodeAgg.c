@@ -2685,6 +2685,8 @@ agg_refill_hash_table(AggState *aggstate)
 	HashAggSpill spill;
 	LogicalTapeSet *tapeset = aggstate->hash_tapeset;
 	bool		spill_initialized = false;
+	double		ngroups;
+	uint64		nentries;
 
 	if (aggstate->hash_batches == NIL)
 		return false;
@@ -2730,6 +2732,19 @@ agg_refill_hash_table(AggState *aggstate)
 
 	perhash = &aggstate->perhash[aggstate->current_set];
 
+	/*
+	 * We have a cardinality estimate for the batch, so size the (now empty)
+	 * hash table for the groups we expect to keep in memory up front, rather
+	 * than growing it step by step and rehashing every entry each time.
+	 * Allow for the table's fill factor.  It never shrinks, so this is only
+	 * needed if an earlier batch didn't already make it large enough.
+	 */
+	ngroups = Min(batch->input_card, (double) aggstate->hash_ngroups_limit);
+	nentries = (uint64) (ngroups / 0.9) + 1;
+	if (nentries > perhash->hashtable->hashtab->size &&
+		nentries <= PG_UINT32_MAX)
+		tuplehash_grow(perhash->hashtable->hashtab, nentries);
+
 	/*
 	 * Spilled tuples are always read back as MinimalTuples, which may be
 	 * different from the outer plan, so recompile the aggregate expressions.
@@ -42,6 +42,7 @@
 #include "utils/wait_event.h"
 
 static void ExecHashIncreaseNumBatches(HashJoinTable hashtable);
+static void ExecHashCreateInnerFilter(HashJoinTable hashtable, double ntuples);
 static void ExecHashIncreaseNumBuckets(HashJoinTable hashtable);
 static void ExecParallelHashIncreaseNumBatches(HashJoinTable hashtable);
 static void ExecParallelHashIncreaseNumBuckets(HashJoinTable hashtable);
@@ -191,6 +192,11 @@ MultiExecPrivateHash(HashState *node)
 				ExecHashTableInsert(hashtable, slot, hashvalue);
 			}
 			hashtable->totalTuples += 1;
+
+			if (hashtable->innerFilter)
+				bloom_add_element(hashtable->innerFilter,
+								  (unsigned char *) &hashvalue,
+								  sizeof(hashvalue));
 		}
 	}
 
@@ -511,6 +517,8 @@ ExecHashTableCreate(HashState *state)
 	hashtable->skewTuples = 0;
 	hashtable->innerBatchFile = NULL;
 	hashtable->outerBatchFile = NULL;
+	hashtable->innerFilter = NULL;
+	hashtable->innerFilterSpace = 0;
 	hashtable->spaceUsed = 0;
 	hashtable->spacePeak = 0;
 	hashtable->spaceAllowed = space_allowed;
@@ -566,6 +574,8 @@ ExecHashTableCreate(HashState *state)
 		/* The files will not be opened until needed... */
 		/* ... but make sure we have temp tablespaces established for them */
 		PrepareTempTablespaces();
+
+		ExecHashCreateInnerFilter(hashtable, rows);
 	}
 
 	MemoryContextSwitchTo(oldcxt);
@@ -1020,6 +1030,44 @@ ExecHashIncreaseBatchSize(HashJoinTable hashtable)
 	return false;
 }
 
+/*
+ * ExecHashCreateInnerFilter
+ *		set up the Bloom filter over inner hash values for a multi-batch join
+ *
+ * The filter lives in hashCxt, as it must cover the tuples of all batches,
+ * and it is charged to spaceUsed like the tuples are, so that it is taken
+ * into account when deciding whether to increase the number of batches.
+ * It is sized by bloom_create() from the expected number of inner tuples,
+ * limited to INNER_FILTER_HASH_MEM_PERCENT of spaceAllowed.  As that function
+ * won't make a filter smaller than 1MB, we do without one if that limit is
+ * any less.
+ */
+static void
+ExecHashCreateInnerFilter(HashJoinTable hashtable, double ntuples)
+{
+	size_t		filter_space;
+	MemoryContext oldcxt;
+
+	Assert(hashtable->parallel_state == NULL);
+	Assert(hashtable->innerFilter == NULL);
+
+	filter_space = hashtable->spaceAllowed * INNER_FILTER_HASH_MEM_PERCENT / 100;
+	if (filter_space < 1024 * 1024)
+		return;
+
+	oldcxt = MemoryContextSwitchTo(hashtable->hashCxt);
+	hashtable->innerFilter = bloom_create((int64) Max(ntuples, 1.0),
+										  (int) Min(filter_space / 1024,
+													INT_MAX),
+										  0);
+	MemoryContextSwitchTo(oldcxt);
+
+	hashtable->innerFilterSpace = GetMemoryChunkSpace(hashtable->innerFilter);
+	hashtable->spaceUsed += hashtable->innerFilterSpace;
+	if (hashtable->spaceUsed > hashtable->spacePeak)
+		hashtable->spacePeak = hashtable->spaceUsed;
+}
+
 /*
  * ExecHashIncreaseNumBatches
  *		increase the original number of batches in order to reduce
@@ -1067,6 +1115,15 @@ ExecHashIncreaseNumBatches(HashJoinTable hashtable)
 
 		/* time to establish the temp tablespaces, too */
 		PrepareTempTablespaces();
+
+		/*
+		 * We're still building the first batch, so every inner tuple seen so
+		 * far is in memory; they're added to the filter in the loop below.
+		 * Evidently the planner's estimate was too low, so assume at least
+		 * as many tuples again are still to come.
+		 */
+		Assert(curbatch == 0);
+		ExecHashCreateInnerFilter(hashtable, hashtable->totalTuples * 2);
 	}
 	else
 	{
@@ -1128,6 +1185,11 @@ ExecHashIncreaseNumBatches(HashJoinTable hashtable)
 			ExecHashGetBucketAndBatch(hashtable, hashTuple->hashvalue,
 									  &bucketno, &batchno);
 
+			if (oldnbatch == 1 && hashtable->innerFilter)
+				bloom_add_element(hashtable->innerFilter,
+								  (unsigned char *) &hashTuple->hashvalue,
+								  sizeof(hashTuple->hashvalue));
+
 			if (batchno == curbatch)
 			{
 				/* keep tuple in memory - copy it into the new chunk */
@@ -2016,6 +2078,14 @@ ExecScanHashBucket(HashJoinState *hjstate,
 		{
 			TupleTableSlot *inntuple;
 
+			/*
+			 * Start loading the next tuple in the chain, which is likely a
+			 * cache miss.  Evaluating the join clauses here, or emitting the
+			 * join tuple when they match, gives time for that to complete
+			 * before we continue the scan.
+			 */
+			pg_prefetch_mem(hashTuple->next.unshared);
+
 			/* insert hashtable's tuple into exec slot so ExecQual sees it */
 			inntuple = ExecStoreMinimalTuple(HJTUPLE_MINTUPLE(hashTuple),
 											 hjstate->hj_HashTupleSlot,
@@ -2338,7 +2408,8 @@ ExecHashTableReset(HashJoinTable hashtable)
 	/* Reallocate and reinitialize the hash bucket headers. */
 	hashtable->buckets.unshared = palloc0_array(HashJoinTuple, nbuckets);
 
-	hashtable->spaceUsed = 0;
+	/* The inner filter, if any, survives; it covers all batches */
+	hashtable->spaceUsed = hashtable->innerFilterSpace;
 
 	MemoryContextSwitchTo(oldcxt);
 
@@ -482,8 +482,24 @@ ExecHashJoinImpl(PlanState *pstate, bool parallel)
 					node->hj_CurSkewBucketNo == INVALID_SKEW_BUCKET_NO)
 				{
 					bool		shouldFree;
-					MinimalTuple mintuple = ExecFetchSlotMinimalTuple(outerTupleSlot,
-																	  &shouldFree);
+					MinimalTuple mintuple;
+
+					/*
+					 * If no inner tuple has this hash value, the outer tuple
+					 * cannot have a match in any batch, so don't bother to
+					 * save it.  Go straight to the outer-join fill check.
+					 */
+					if (hashtable->innerFilter &&
+						bloom_lacks_element(hashtable->innerFilter,
+											(unsigned char *) &hashvalue,
+											sizeof(hashvalue)))
+					{
+						node->hj_JoinState = HJ_FILL_OUTER_TUPLE;
+						continue;
+					}
+
+					mintuple = ExecFetchSlotMinimalTuple(outerTupleSlot,
+														 &shouldFree);
 
 					/*
 					 * Need to postpone this outer tuple to a later batch.
@@ -1224,6 +1240,10 @@ ExecHashJoinNewBatch(HashJoinState *hjstate)
 
 	if (innerFile != NULL)
 	{
+		/*
+		 * Batch files may be compressed (see BufFileCreateCompressTemp), so
+		 * rewinding to the start is the only seek we can do on them.
+		 */
 		if (BufFileSeek(innerFile, 0, 0, SEEK_SET))
 			ereport(ERROR,
 					(errcode_for_file_access(),
@@ -1251,6 +1271,7 @@ ExecHashJoinNewBatch(HashJoinState *hjstate)
 
 	/*
 	 * Rewind outer batch file (if present), so that we can start reading it.
+	 * As for the inner file, this must be a rewind to the start.
 	 */
 	if (hashtable->outerBatchFile[curbatch] != NULL)
 	{
@@ -1434,7 +1455,7 @@ ExecHashJoinSaveTuple(MinimalTuple tuple, uint32 hashvalue,
 	{
 		MemoryContext oldctx = MemoryContextSwitchTo(hashtable->spillCxt);
 
-		file = BufFileCreateTemp(false);
+		file = BufFileCreateCompressTemp(false);
 		*fileptr = file;
 
 		MemoryContextSwitchTo(oldctx);
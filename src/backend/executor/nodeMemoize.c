@@ -421,6 +421,7 @@ cache_purge_all(MemoizeState *mstate)
 	dlist_init(&mstate->lru_list);
 	mstate->last_tuple = NULL;
 	mstate->entry = NULL;
+	mstate->last_lookup = NULL;
 
 	mstate->mem_used = 0;
 
@@ -535,6 +536,26 @@ cache_lookup(MemoizeState *mstate, bool *found)
 	/* prepare the probe slot with the current scan parameters */
 	prepare_probe_slot(mstate, NULL);
 
+	/*
+	 * The outer side of a nested loop often produces runs of rows with the
+	 * same parameter values, so first check whether the entry we returned
+	 * last time matches, which saves hashing the parameters and probing the
+	 * hash table.  Deletions may have moved another entry into that bucket,
+	 * or emptied it, so check its status and key.  The pointer itself stays
+	 * valid since the hash table can only grow in memoize_insert() below.
+	 */
+	entry = mstate->last_lookup;
+	if (entry != NULL && entry->status == memoize_SH_IN_USE &&
+		MemoizeHash_equal(mstate->hashtable, entry->key, NULL))
+	{
+		*found = true;
+		dlist_move_tail(&mstate->lru_list, &entry->key->lru_node);
+		return entry;
+	}
+
+	/* memoize_insert() may grow the table, invalidating the pointer */
+	mstate->last_lookup = NULL;
+
 	/*
 	 * Add the new entry to the cache.  No need to pass a valid key since the
 	 * hash function uses mstate's probeslot, which we populated above.
@@ -549,6 +570,7 @@ cache_lookup(MemoizeState *mstate, bool *found)
 		 */
 		dlist_move_tail(&mstate->lru_list, &entry->key->lru_node);
 
+		mstate->last_lookup = entry;
 		return entry;
 	}
 
@@ -612,6 +634,7 @@ cache_lookup(MemoizeState *mstate, bool *found)
 		}
 	}
 
+	mstate->last_lookup = entry;
 	return entry;
 }
 
@@ -1047,6 +1070,7 @@ ExecInitMemoize(Memoize *node, EState *estate, int eflags)
 	dlist_init(&mstate->lru_list);
 	mstate->last_tuple = NULL;
 	mstate->entry = NULL;
+	mstate->last_lookup = NULL;
 
 	/*
 	 * Mark if we can assume the cache entry is completed after we get the
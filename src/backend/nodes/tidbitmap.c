@@ -75,6 +75,15 @@
 /* number of active words for a lossy chunk: */
 #define WORDS_PER_CHUNK  ((PAGES_PER_CHUNK - 1) / BITS_PER_BITMAPWORD + 1)
 
+/*
+ * A shared iterator hands out up to this many exact pages to a participant
+ * per acquisition of the shared lock, but proportionally fewer as the
+ * remaining pages run out, so that participants finish at about the same
+ * time.
+ */
+#define SHARED_ITERATE_BATCH_PAGES		8
+#define SHARED_ITERATE_BATCH_DIVISOR	64
+
 /*
  * The hashtable entries are represented by this data structure.  For
  * an exact page, blockno is the page number and bit k of the bitmap
@@ -213,6 +222,8 @@ struct TBMSharedIterator
 	PTEntryArray *ptbase;		/* pagetable element array */
 	PTIterationArray *ptpages;	/* sorted exact page index list */
 	PTIterationArray *ptchunks; /* sorted lossy page index list */
+	int			batchptr;		/* next spages index of our batch */
+	int			batchend;		/* end of our batch of spages indexes */
 };
 
 /* Local function prototypes */
@@ -1057,6 +1068,7 @@ tbm_shared_iterate(TBMSharedIterator *iterator, TBMIterateResult *tbmres)
 	PagetableEntry *ptbase = NULL;
 	int		   *idxpages = NULL;
 	int		   *idxchunks = NULL;
+	BlockNumber chunk_blockno = InvalidBlockNumber;
 
 	if (iterator->ptbase != NULL)
 		ptbase = iterator->ptbase->ptentry;
@@ -1065,6 +1077,18 @@ tbm_shared_iterate(TBMSharedIterator *iterator, TBMIterateResult *tbmres)
 	if (iterator->ptchunks != NULL)
 		idxchunks = iterator->ptchunks->index;
 
+	/* Return the next page of the batch we claimed earlier, if any */
+	if (iterator->batchptr < iterator->batchend)
+	{
+		PagetableEntry *page = &ptbase[idxpages[iterator->batchptr++]];
+
+		tbmres->internal_page = page;
+		tbmres->blockno = page->blockno;
+		tbmres->lossy = false;
+		tbmres->recheck = page->recheck;
+		return true;
+	}
+
 	/* Acquire the LWLock before accessing the shared members */
 	LWLockAcquire(&istate->lock, LW_EXCLUSIVE);
 
@@ -1095,7 +1119,6 @@ tbm_shared_iterate(TBMSharedIterator *iterator, TBMIterateResult *tbmres)
 	if (istate->schunkptr < istate->nchunks)
 	{
 		PagetableEntry *chunk = &ptbase[idxchunks[istate->schunkptr]];
-		BlockNumber chunk_blockno;
 
 		chunk_blockno = chunk->blockno + istate->schunkbit;
 
@@ -1117,12 +1140,31 @@ tbm_shared_iterate(TBMSharedIterator *iterator, TBMIterateResult *tbmres)
 	if (istate->spageptr < istate->npages)
 	{
 		PagetableEntry *page = &ptbase[idxpages[istate->spageptr]];
+		int			nbatch;
+		int			n;
 
 		tbmres->internal_page = page;
 		tbmres->blockno = page->blockno;
 		tbmres->lossy = false;
 		tbmres->recheck = page->recheck;
-		istate->spageptr++;
+
+		/*
+		 * Claim some following exact pages too, to be returned by later calls
+		 * without taking the lock.  Stop before any page that follows the
+		 * next lossy page, so that we still output lossy and exact pages in
+		 * block number order.
+		 */
+		nbatch = Min(SHARED_ITERATE_BATCH_PAGES,
+					 (istate->npages - istate->spageptr) /
+					 SHARED_ITERATE_BATCH_DIVISOR);
+		for (n = 1; n < nbatch; n++)
+		{
+			if (ptbase[idxpages[istate->spageptr + n]].blockno >= chunk_blockno)
+				break;
+		}
+		iterator->batchptr = istate->spageptr + 1;
+		iterator->batchend = istate->spageptr + n;
+		istate->spageptr += n;
 
 		LWLockRelease(&istate->lock);
 
@@ -196,6 +196,14 @@ typedef struct av_relation
 								 * reloptions, or NULL if none */
 } av_relation;
 
+/* struct to keep track of tables to vacuum and/or analyze, in priority order */
+typedef struct av_candidate
+{
+	Oid			ac_relid;
+	bool		ac_wraparound;	/* vacuum forced for wraparound? */
+	float4		ac_score;		/* how far past its thresholds the table is */
+} av_candidate;
+
 /* struct to keep track of tables to vacuum and/or analyze, after rechecking */
 typedef struct autovac_table
 {
@@ -344,11 +352,13 @@ static void recheck_relation_needs_vacanalyze(Oid relid, AutoVacOpts *avopts,
 											  Form_pg_class classForm,
 											  int effective_multixact_freeze_max_age,
 											  bool *dovacuum, bool *doanalyze, bool *wraparound);
+static int	av_candidate_cmp(const ListCell *a, const ListCell *b);
 static void relation_needs_vacanalyze(Oid relid, AutoVacOpts *relopts,
 									  Form_pg_class classForm,
 									  PgStat_StatTabEntry *tabentry,
 									  int effective_multixact_freeze_max_age,
-									  bool *dovacuum, bool *doanalyze, bool *wraparound);
+									  bool *dovacuum, bool *doanalyze, bool *wraparound,
+									  float4 *score);
 
 static void autovacuum_do_vac_analyze(autovac_table *tab,
 									  BufferAccessStrategy bstrategy);
@@ -1878,6 +1888,7 @@ do_autovacuum(void)
 	HeapTuple	tuple;
 	TableScanDesc relScan;
 	Form_pg_database dbForm;
+	List	   *candidates = NIL;
 	List	   *table_oids = NIL;
 	List	   *orphan_oids = NIL;
 	HASHCTL		ctl;
@@ -1990,6 +2001,7 @@ do_autovacuum(void)
 		bool		dovacuum;
 		bool		doanalyze;
 		bool		wraparound;
+		float4		score;
 
 		if (classForm->relkind != RELKIND_RELATION &&
 			classForm->relkind != RELKIND_MATVIEW)
@@ -2030,11 +2042,18 @@ do_autovacuum(void)
 		/* Check if it needs vacuum or analyze */
 		relation_needs_vacanalyze(relid, relopts, classForm, tabentry,
 								  effective_multixact_freeze_max_age,
-								  &dovacuum, &doanalyze, &wraparound);
+								  &dovacuum, &doanalyze, &wraparound, &score);
 
-		/* Relations that need work are added to table_oids */
+		/* Relations that need work are added to the candidates */
 		if (dovacuum || doanalyze)
-			table_oids = lappend_oid(table_oids, relid);
+		{
+			av_candidate *cand = palloc_object(av_candidate);
+
+			cand->ac_relid = relid;
+			cand->ac_wraparound = wraparound;
+			cand->ac_score = score;
+			candidates = lappend(candidates, cand);
+		}
 
 		/*
 		 * Remember TOAST associations for the second pass.  Note: we must do
@@ -2090,6 +2109,7 @@ do_autovacuum(void)
 		bool		dovacuum;
 		bool		doanalyze;
 		bool		wraparound;
+		float4		score;
 
 		/*
 		 * We cannot safely process other backends' temp tables, so skip 'em.
@@ -2122,11 +2142,18 @@ do_autovacuum(void)
 
 		relation_needs_vacanalyze(relid, relopts, classForm, tabentry,
 								  effective_multixact_freeze_max_age,
-								  &dovacuum, &doanalyze, &wraparound);
+								  &dovacuum, &doanalyze, &wraparound, &score);
 
 		/* ignore analyze for toast tables */
 		if (dovacuum)
-			table_oids = lappend_oid(table_oids, relid);
+		{
+			av_candidate *cand = palloc_object(av_candidate);
+
+			cand->ac_relid = relid;
+			cand->ac_wraparound = wraparound;
+			cand->ac_score = score;
+			candidates = lappend(candidates, cand);
+		}
 
 		/* Release stuff to avoid leakage */
 		if (free_relopts)
@@ -2138,6 +2165,17 @@ do_autovacuum(void)
 	table_endscan(relScan);
 	table_close(classRel, AccessShareLock);
 
+	/*
+	 * Process the tables most in need first: those at risk of wraparound,
+	 * then by decreasing score.  Otherwise, in a large database, small but
+	 * heavily updated tables could wait behind every table that merely
+	 * crossed its threshold and happened to come earlier in pg_class.
+	 */
+	list_sort(candidates, av_candidate_cmp);
+	foreach_ptr(av_candidate, cand, candidates)
+		table_oids = lappend_oid(table_oids, cand->ac_relid);
+	list_free_deep(candidates);
+
 	/*
 	 * Recheck orphan temporary tables, and if they still seem orphaned, drop
 	 * them.  We'll eat a transaction per dropped table, which might seem
@@ -2895,6 +2933,22 @@ table_recheck_autovac(Oid relid, HTAB *table_toast_map,
 	return tab;
 }
 
+/*
+ * list_sort comparator for av_candidate, most urgent first
+ */
+static int
+av_candidate_cmp(const ListCell *a, const ListCell *b)
+{
+	const av_candidate *ca = lfirst(a);
+	const av_candidate *cb = lfirst(b);
+
+	if (ca->ac_wraparound != cb->ac_wraparound)
+		return ca->ac_wraparound ? -1 : 1;
+	if (ca->ac_score != cb->ac_score)
+		return ca->ac_score > cb->ac_score ? -1 : 1;
+	return 0;
+}
+
 /*
  * recheck_relation_needs_vacanalyze
  *
@@ -2913,6 +2967,7 @@ recheck_relation_needs_vacanalyze(Oid relid,
 								  bool *wraparound)
 {
 	PgStat_StatTabEntry *tabentry;
+	float4		score;
 
 	/* fetch the pgstat table entry */
 	tabentry = pgstat_fetch_stat_tabentry_ext(classForm->relisshared,
@@ -2920,7 +2975,7 @@ recheck_relation_needs_vacanalyze(Oid relid,
 
 	relation_needs_vacanalyze(relid, avopts, classForm, tabentry,
 							  effective_multixact_freeze_max_age,
-							  dovacuum, doanalyze, wraparound);
+							  dovacuum, doanalyze, wraparound, &score);
 
 	/* Release tabentry to avoid leakage */
 	if (tabentry)
@@ -2936,7 +2991,8 @@ recheck_relation_needs_vacanalyze(Oid relid,
  *
  * Check whether a relation needs to be vacuumed or analyzed; return each into
  * "dovacuum" and "doanalyze", respectively.  Also return whether the vacuum is
- * being forced because of Xid or multixact wraparound.
+ * being forced because of Xid or multixact wraparound, and in "score" how
+ * urgently the relation needs attention, for ordering the work.
  *
  * relopts is a pointer to the AutoVacOpts options (either for itself in the
  * case of a plain table, or for either itself or its parent table in the case
@@ -2969,6 +3025,11 @@ recheck_relation_needs_vacanalyze(Oid relid,
  * autovacuum_vacuum_threshold GUC variable.  Similarly, a vac_scale_factor
  * value < 0 is substituted with the value of
  * autovacuum_vacuum_scale_factor GUC variable.  Ditto for analyze.
+ *
+ * The score is the largest of the ratios of dead, inserted and modified
+ * tuples to their respective thresholds, so that a table far past one of
+ * its thresholds is processed before one that only barely exceeds it.  The
+ * modified-tuple ratio only counts if the table will be analyzed.
  */
 static void
 relation_needs_vacanalyze(Oid relid,
@@ -2979,7 +3040,8 @@ relation_needs_vacanalyze(Oid relid,
  /* output params below */
 						  bool *dovacuum,
 						  bool *doanalyze,
-						  bool *wraparound)
+						  bool *wraparound,
+						  float4 *score)
 {
 	bool		force_vacuum;
 	bool		av_enabled;
@@ -3010,6 +3072,9 @@ relation_needs_vacanalyze(Oid relid,
 	TransactionId relfrozenxid;
 	MultiXactId multiForceLimit;
 
+	/* urgency of the analyze, counted once we know it will happen */
+	float4		anlscore = 0;
+
 	Assert(classForm != NULL);
 	Assert(OidIsValid(relid));
 
@@ -3078,6 +3143,7 @@ relation_needs_vacanalyze(Oid relid,
 			MultiXactIdPrecedes(relminmxid, multiForceLimit);
 	}
 	*wraparound = force_vacuum;
+	*score = 0;
 
 	/* User disabled it in pg_class.reloptions?  (But ignore if at risk) */
 	if (!av_enabled && !force_vacuum)
@@ -3147,6 +3213,12 @@ relation_needs_vacanalyze(Oid relid,
 		*dovacuum = force_vacuum || (vactuples > vacthresh) ||
 			(vac_ins_base_thresh >= 0 && instuples > vacinsthresh);
 		*doanalyze = (anltuples > anlthresh);
+
+		/* Rate how badly it needs it */
+		*score = vactuples / Max(vacthresh, 1);
+		if (vac_ins_base_thresh >= 0)
+			*score = Max(*score, instuples / Max(vacinsthresh, 1));
+		anlscore = anltuples / Max(anlthresh, 1);
 	}
 	else
 	{
@@ -3162,6 +3234,13 @@ relation_needs_vacanalyze(Oid relid,
 	/* ANALYZE refuses to work with pg_statistic */
 	if (relid == StatisticRelationId)
 		*doanalyze = false;
+
+	/*
+	 * Modified tuples only add to the score if we will actually analyze the
+	 * table.  TOAST tables never are; the callers ignore doanalyze for them.
+	 */
+	if (*doanalyze && classForm->relkind != RELKIND_TOASTVALUE)
+		*score = Max(*score, anlscore);
 }
 
 /*
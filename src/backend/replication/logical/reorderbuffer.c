@@ -147,12 +147,18 @@ typedef struct ReorderBufferTupleCidEnt
 	CommandId	combocid;		/* just for debugging */
 } ReorderBufferTupleCidEnt;
 
-/* Virtual file descriptor with file offset tracking */
+/*
+ * Virtual file descriptor with file offset tracking, and a buffer so that
+ * restoring many small changes doesn't cost two read calls each.
+ */
 typedef struct TXNEntryFile
 {
 	File		vfd;			/* -1 when the file is closed */
-	off_t		curOffset;		/* offset for next write or read. Reset to 0
-								 * when vfd is opened. */
+	off_t		curOffset;		/* offset for next read from the file. Reset
+								 * to 0 when vfd is opened. */
+	char	   *readbuf;		/* BLCKSZ read buffer, or NULL */
+	int			readbuf_len;	/* number of valid bytes in readbuf */
+	int			readbuf_pos;	/* next byte of readbuf to return */
 } TXNEntryFile;
 
 /* k-way in-order change iteration support structures */
@@ -268,6 +274,7 @@ static void ReorderBufferSerializeChange(ReorderBuffer *rb, ReorderBufferTXN *tx
 										 int fd, ReorderBufferChange *change);
 static Size ReorderBufferRestoreChanges(ReorderBuffer *rb, ReorderBufferTXN *txn,
 										TXNEntryFile *file, XLogSegNo *segno);
+static int	ReorderBufferReadSpillFile(TXNEntryFile *file, char *dst, int len);
 static void ReorderBufferRestoreChange(ReorderBuffer *rb, ReorderBufferTXN *txn,
 									   char *data);
 static void ReorderBufferRestoreCleanup(ReorderBuffer *rb, ReorderBufferTXN *txn);
@@ -1510,6 +1517,8 @@ ReorderBufferIterTXNFinish(ReorderBuffer *rb,
 	{
 		if (state->entries[off].file.vfd != -1)
 			FileClose(state->entries[off].file.vfd);
+		if (state->entries[off].file.readbuf != NULL)
+			pfree(state->entries[off].file.readbuf);
 	}
 
 	/* free memory we might have "leaked" in the last *Next call */
@@ -4591,10 +4600,16 @@ ReorderBufferRestoreChanges(ReorderBuffer *rb, ReorderBufferTXN *txn,
 			ReorderBufferSerializedPath(path, MyReplicationSlot, txn->xid,
 										*segno);
 
+			/* Set up the read buffer first, so as not to clobber errno */
+			if (file->readbuf == NULL)
+				file->readbuf = MemoryContextAlloc(rb->context, BLCKSZ);
+
 			*fd = PathNameOpenFile(path, O_RDONLY | PG_BINARY);
 
 			/* No harm in resetting the offset even in case of failure */
 			file->curOffset = 0;
+			file->readbuf_len = 0;
+			file->readbuf_pos = 0;
 
 			if (*fd < 0 && errno == ENOENT)
 			{
@@ -4615,9 +4630,8 @@ ReorderBufferRestoreChanges(ReorderBuffer *rb, ReorderBufferTXN *txn,
 		 * end of this file.
 		 */
 		ReorderBufferSerializeReserve(rb, sizeof(ReorderBufferDiskChange));
-		readBytes = FileRead(file->vfd, rb->outbuf,
-							 sizeof(ReorderBufferDiskChange),
-							 file->curOffset, WAIT_EVENT_REORDER_BUFFER_READ);
+		readBytes = ReorderBufferReadSpillFile(file, rb->outbuf,
+											   sizeof(ReorderBufferDiskChange));
 
 		/* eof */
 		if (readBytes == 0)
@@ -4638,19 +4652,15 @@ ReorderBufferRestoreChanges(ReorderBuffer *rb, ReorderBufferTXN *txn,
 							readBytes,
 							(uint32) sizeof(ReorderBufferDiskChange))));
 
-		file->curOffset += readBytes;
-
 		ondisk = (ReorderBufferDiskChange *) rb->outbuf;
 
 		ReorderBufferSerializeReserve(rb,
 									  sizeof(ReorderBufferDiskChange) + ondisk->size);
 		ondisk = (ReorderBufferDiskChange *) rb->outbuf;
 
-		readBytes = FileRead(file->vfd,
-							 rb->outbuf + sizeof(ReorderBufferDiskChange),
-							 ondisk->size - sizeof(ReorderBufferDiskChange),
-							 file->curOffset,
-							 WAIT_EVENT_REORDER_BUFFER_READ);
+		readBytes = ReorderBufferReadSpillFile(file,
+											   rb->outbuf + sizeof(ReorderBufferDiskChange),
+											   ondisk->size - sizeof(ReorderBufferDiskChange));
 
 		if (readBytes < 0)
 			ereport(ERROR,
@@ -4663,8 +4673,6 @@ ReorderBufferRestoreChanges(ReorderBuffer *rb, ReorderBufferTXN *txn,
 							readBytes,
 							(uint32) (ondisk->size - sizeof(ReorderBufferDiskChange)))));
 
-		file->curOffset += readBytes;
-
 		/*
 		 * ok, read a full change from disk, now restore it into proper
 		 * in-memory format
@@ -4676,6 +4684,57 @@ ReorderBufferRestoreChanges(ReorderBuffer *rb, ReorderBufferTXN *txn,
 	return restored;
 }
 
+/*
+ * Read up to 'len' bytes from a spill file into 'dst', going through the
+ * file's read buffer.  Returns the number of bytes read, which is less than
+ * 'len' only at the end of the file, or -1 on error with errno set.
+ */
+static int
+ReorderBufferReadSpillFile(TXNEntryFile *file, char *dst, int len)
+{
+	int			copied = 0;
+
+	while (copied < len)
+	{
+		int			nbytes;
+
+		if (file->readbuf_pos >= file->readbuf_len)
+		{
+			int			readBytes;
+
+			/* Read large changes directly into the destination */
+			if (len - copied >= BLCKSZ)
+			{
+				readBytes = FileRead(file->vfd, dst + copied, len - copied,
+									 file->curOffset,
+									 WAIT_EVENT_REORDER_BUFFER_READ);
+				if (readBytes < 0)
+					return -1;
+				file->curOffset += readBytes;
+				return copied + readBytes;
+			}
+
+			readBytes = FileRead(file->vfd, file->readbuf, BLCKSZ,
+								 file->curOffset,
+								 WAIT_EVENT_REORDER_BUFFER_READ);
+			if (readBytes < 0)
+				return -1;
+			if (readBytes == 0)
+				break;			/* eof */
+			file->curOffset += readBytes;
+			file->readbuf_len = readBytes;
+			file->readbuf_pos = 0;
+		}
+
+		nbytes = Min(len - copied, file->readbuf_len - file->readbuf_pos);
+		memcpy(dst + copied, file->readbuf + file->readbuf_pos, nbytes);
+		file->readbuf_pos += nbytes;
+		copied += nbytes;
+	}
+
+	return copied;
+}
+
 /*
  * Convert change from its on-disk format to in-memory format and queue it onto
  * the TXN's ->changes list.
@@ -64,6 +64,7 @@
 #include "storage/smgr.h"
 #include "storage/standby.h"
 #include "utils/memdebug.h"
+#include "utils/memutils.h"
 #include "utils/ps_status.h"
 #include "utils/rel.h"
 #include "utils/resowner.h"
@@ -627,6 +628,12 @@ static void UnpinBufferNoOwner(BufferDesc *buf);
 static void BufferSync(int flags);
 static int	SyncOneBuffer(int buf_id, bool skip_recently_used,
 						  WritebackContext *wb_context);
+static int	CheckpointRunLength(CkptTsStatus *ts_stat);
+static int	SyncBufferRun(CkptSortItem *items, int nitems,
+						  WritebackContext *wb_context);
+static void WriteBufferRun(BufferDesc **bufs, int nbufs, IOContext io_context);
+static int	FlushStrategyRun(BufferAccessStrategy strategy, BufferDesc *victim,
+							 IOContext io_context);
 static void WaitIO(BufferDesc *buf);
 static void AbortBufferIO(Buffer buffer);
 static void shared_buffer_write_error_callback(void *arg);
@@ -2539,8 +2546,14 @@ again:
 			}
 		}
 
-		/* OK, do the I/O */
-		FlushBuffer(buf_hdr, NULL, IOOBJECT_RELATION, io_context);
+		/*
+		 * OK, do the I/O.  If the victim came from the strategy ring, try to
+		 * write out the following ring buffers along with it.
+		 */
+		if (from_ring && io_combine_limit > 1)
+			FlushStrategyRun(strategy, buf_hdr, io_context);
+		else
+			FlushBuffer(buf_hdr, NULL, IOOBJECT_RELATION, io_context);
 		LockBuffer(buf, BUFFER_LOCK_UNLOCK);
 
 		ScheduleBufferTagForWriteback(&BackendWritebackContext, io_context,
@@ -3667,7 +3680,26 @@ BufferSync(int flags)
 		 */
 		if (pg_atomic_read_u64(&bufHdr->state) & BM_CHECKPOINT_NEEDED)
 		{
-			if (SyncOneBuffer(buf_id, false, &wb_context) & BUF_WRITTEN)
+			int			run_length = CheckpointRunLength(ts_stat);
+
+			/*
+			 * If the following to-be-checkpointed buffers hold the next
+			 * blocks of the same relation fork, write them together with a
+			 * single vectored write.  The buffers written ahead of the
+			 * current position get their BM_CHECKPOINT_NEEDED flag cleared,
+			 * so when we get to them below they're just counted as
+			 * processed.
+			 */
+			if (run_length > 1)
+			{
+				int			nwritten;
+
+				nwritten = SyncBufferRun(&CkptBufferIds[ts_stat->index],
+										 run_length, &wb_context);
+				PendingCheckpointerStats.buffers_written += nwritten;
+				num_written += nwritten;
+			}
+			else if (SyncOneBuffer(buf_id, false, &wb_context) & BUF_WRITTEN)
 			{
 				TRACE_POSTGRESQL_BUFFER_SYNC_WRITTEN(buf_id);
 				PendingCheckpointerStats.buffers_written++;
@@ -3721,11 +3753,47 @@ BufferSync(int flags)
 	TRACE_POSTGRESQL_BUFFER_SYNC_DONE(NBuffers, num_written, num_to_scan);
 }
 
+/*
+ * State kept by BgBufferSync() for each clock-sweep partition.  Buffer
+ * positions are relative to the start of the partition.
+ */
+typedef struct BgBufferSyncPartitionState
+{
+	/* info obtained from freelist.c by the current call */
+	int			first_buffer;
+	int			num_buffers;
+	int			strategy_buf_id;
+	uint32		strategy_passes;
+	uint32		recent_alloc;
+
+	/*
+	 * Information saved between calls so we can determine the strategy
+	 * point's advance rate and avoid scanning already-cleaned buffers.
+	 */
+	bool		saved_info_valid;
+	int			prev_strategy_buf_id;
+	uint32		prev_strategy_passes;
+	int			next_to_clean;
+	uint32		next_passes;
+
+	/* Moving averages of allocation rate and clean-buffer density */
+	float		smoothed_alloc;
+	float		smoothed_density;
+} BgBufferSyncPartitionState;
+
+static bool BgBufferSyncPartition(BgBufferSyncPartitionState *part,
+								  int max_pages, bool *hit_max_pages,
+								  WritebackContext *wb_context);
+
 /*
  * BgBufferSync -- Write out some dirty buffers in the pool.
  *
  * This is called periodically by the background writer process.
  *
+ * Each clock-sweep partition has its own clock hand and allocation rate, so
+ * we run the LRU scan separately for each of them, giving each its share of
+ * bgwriter_lru_maxpages.
+ *
  * Returns true if it's appropriate for the bgwriter process to go into
  * low-power hibernation mode.  (This happens if the strategy clock-sweep
  * has been "lapped" and no buffer allocations have occurred recently,
@@ -3735,24 +3803,92 @@ BufferSync(int flags)
 bool
 BgBufferSync(WritebackContext *wb_context)
 {
-	/* info obtained from freelist.c */
-	int			strategy_buf_id;
-	uint32		strategy_passes;
-	uint32		recent_alloc;
+	static BgBufferSyncPartitionState *partitions = NULL;
+	int			numPartitions = StrategyNumPartitions();
+	uint32		recent_alloc = 0;
+	bool		hit_max_pages = false;
+	bool		hibernate = true;
+
+	if (partitions == NULL)
+	{
+		partitions = (BgBufferSyncPartitionState *)
+			MemoryContextAllocZero(TopMemoryContext,
+								   numPartitions * sizeof(BgBufferSyncPartitionState));
+		for (int i = 0; i < numPartitions; i++)
+			partitions[i].smoothed_density = 10.0;
+	}
 
 	/*
-	 * Information saved between calls so we can determine the strategy
-	 * point's advance rate and avoid scanning already-cleaned buffers.
+	 * Find out where each partition's clock-sweep currently is, and how many
+	 * buffer allocations have happened since our last call.
 	 */
-	static bool saved_info_valid = false;
-	static int	prev_strategy_buf_id;
-	static uint32 prev_strategy_passes;
-	static int	next_to_clean;
-	static uint32 next_passes;
+	for (int i = 0; i < numPartitions; i++)
+	{
+		BgBufferSyncPartitionState *part = &partitions[i];
 
-	/* Moving averages of allocation rate and clean-buffer density */
-	static float smoothed_alloc = 0;
-	static float smoothed_density = 10.0;
+		part->strategy_buf_id = StrategySyncStart(i,
+												  &part->first_buffer,
+												  &part->num_buffers,
+												  &part->strategy_passes,
+												  &part->recent_alloc);
+		recent_alloc += part->recent_alloc;
+	}
+
+	/* With all the partitions' allocation counts at hand, rebalance them */
+	StrategyBalancePartitions();
+
+	/* Report buffer alloc counts to pgstat */
+	PendingBgWriterStats.buf_alloc += recent_alloc;
+
+	/*
+	 * If we're not running the LRU scan, just stop after doing the stats
+	 * stuff.  We mark the saved state invalid so that we can recover sanely
+	 * if LRU scan is turned back on later.
+	 */
+	if (bgwriter_lru_maxpages <= 0)
+	{
+		for (int i = 0; i < numPartitions; i++)
+			partitions[i].saved_info_valid = false;
+		return true;
+	}
+
+	for (int i = 0; i < numPartitions; i++)
+	{
+		BgBufferSyncPartitionState *part = &partitions[i];
+		int			max_pages;
+
+		max_pages = (int) ((int64) bgwriter_lru_maxpages * part->num_buffers /
+						   NBuffers);
+		max_pages = Max(max_pages, 1);
+
+		if (!BgBufferSyncPartition(part, max_pages, &hit_max_pages,
+								   wb_context))
+			hibernate = false;
+	}
+
+	if (hit_max_pages)
+		PendingBgWriterStats.maxwritten_clean++;
+
+	return hibernate;
+}
+
+/*
+ * BgBufferSyncPartition -- LRU scan of one clock-sweep partition
+ *
+ * Writes out at most max_pages dirty buffers of the partition, setting
+ * *hit_max_pages if that limit stopped the scan.  Returns true if the
+ * partition's strategy clock-sweep has been lapped and no buffer allocations
+ * have occurred in it recently.
+ */
+static bool
+BgBufferSyncPartition(BgBufferSyncPartitionState *part, int max_pages,
+					  bool *hit_max_pages, WritebackContext *wb_context)
+{
+	/* info obtained from freelist.c */
+	int			strategy_buf_id = part->strategy_buf_id;
+	uint32		strategy_passes = part->strategy_passes;
+	uint32		recent_alloc = part->recent_alloc;
+	int			num_buffers = part->num_buffers;
 
 	/* Potentially these could be tunables, but for now, not */
 	float		smoothing_samples = 16;
@@ -3776,26 +3912,6 @@ BgBufferSync(WritebackContext *wb_context)
 	long		new_strategy_delta;
 	uint32		new_recent_alloc;
 
-	/*
-	 * Find out where the clock-sweep currently is, and how many buffer
-	 * allocations have happened since our last call.
-	 */
-	strategy_buf_id = StrategySyncStart(&strategy_passes, &recent_alloc);
-
-	/* Report buffer alloc counts to pgstat */
-	PendingBgWriterStats.buf_alloc += recent_alloc;
-
-	/*
-	 * If we're not running the LRU scan, just stop after doing the stats
-	 * stuff.  We mark the saved state invalid so that we can recover sanely
-	 * if LRU scan is turned back on later.
-	 */
-	if (bgwriter_lru_maxpages <= 0)
-	{
-		saved_info_valid = false;
-		return true;
-	}
-
 	/*
 	 * Compute strategy_delta = how many buffers have been scanned by the
 	 * clock-sweep since last time.  If first time through, assume none. Then
@@ -3804,34 +3920,34 @@ BgBufferSync(WritebackContext *wb_context)
 	 * weird-looking coding of xxx_passes comparisons are to avoid bogus
 	 * behavior when the passes counts wrap around.
 	 */
-	if (saved_info_valid)
+	if (part->saved_info_valid)
 	{
-		int32		passes_delta = strategy_passes - prev_strategy_passes;
+		int32		passes_delta = strategy_passes - part->prev_strategy_passes;
 
-		strategy_delta = strategy_buf_id - prev_strategy_buf_id;
-		strategy_delta += (long) passes_delta * NBuffers;
+		strategy_delta = strategy_buf_id - part->prev_strategy_buf_id;
+		strategy_delta += (long) passes_delta * num_buffers;
 
 		Assert(strategy_delta >= 0);
 
-		if ((int32) (next_passes - strategy_passes) > 0)
+		if ((int32) (part->next_passes - strategy_passes) > 0)
 		{
 			/* we're one pass ahead of the strategy point */
-			bufs_to_lap = strategy_buf_id - next_to_clean;
+			bufs_to_lap = strategy_buf_id - part->next_to_clean;
 #ifdef BGW_DEBUG
 			elog(DEBUG2, "bgwriter ahead: bgw %u-%u strategy %u-%u delta=%ld lap=%d",
-				 next_passes, next_to_clean,
+				 part->next_passes, part->next_to_clean,
 				 strategy_passes, strategy_buf_id,
 				 strategy_delta, bufs_to_lap);
 #endif
 		}
-		else if (next_passes == strategy_passes &&
-				 next_to_clean >= strategy_buf_id)
+		else if (part->next_passes == strategy_passes &&
+				 part->next_to_clean >= strategy_buf_id)
 		{
 			/* on same pass, but ahead or at least not behind */
-			bufs_to_lap = NBuffers - (next_to_clean - strategy_buf_id);
+			bufs_to_lap = num_buffers - (part->next_to_clean - strategy_buf_id);
 #ifdef BGW_DEBUG
 			elog(DEBUG2, "bgwriter ahead: bgw %u-%u strategy %u-%u delta=%ld lap=%d",
-				 next_passes, next_to_clean,
+				 part->next_passes, part->next_to_clean,
 				 strategy_passes, strategy_buf_id,
 				 strategy_delta, bufs_to_lap);
 #endif
@@ -3844,13 +3960,13 @@ BgBufferSync(WritebackContext *wb_context)
 			 */
 #ifdef BGW_DEBUG
 			elog(DEBUG2, "bgwriter behind: bgw %u-%u strategy %u-%u delta=%ld",
-				 next_passes, next_to_clean,
+				 part->next_passes, part->next_to_clean,
 				 strategy_passes, strategy_buf_id,
 				 strategy_delta);
 #endif
-			next_to_clean = strategy_buf_id;
-			next_passes = strategy_passes;
-			bufs_to_lap = NBuffers;
+			part->next_to_clean = strategy_buf_id;
+			part->next_passes = strategy_passes;
+			bufs_to_lap = num_buffers;
 		}
 	}
 	else
@@ -3864,15 +3980,15 @@ BgBufferSync(WritebackContext *wb_context)
 			 strategy_passes, strategy_buf_id);
 #endif
 		strategy_delta = 0;
-		next_to_clean = strategy_buf_id;
-		next_passes = strategy_passes;
-		bufs_to_lap = NBuffers;
+		part->next_to_clean = strategy_buf_id;
+		part->next_passes = strategy_passes;
+		bufs_to_lap = num_buffers;
 	}
 
 	/* Update saved info for next time */
-	prev_strategy_buf_id = strategy_buf_id;
-	prev_strategy_passes = strategy_passes;
-	saved_info_valid = true;
+	part->prev_strategy_buf_id = strategy_buf_id;
+	part->prev_strategy_passes = strategy_passes;
+	part->saved_info_valid = true;
 
 	/*
 	 * Compute how many buffers had to be scanned for each new allocation, ie,
@@ -3883,7 +3999,7 @@ BgBufferSync(WritebackContext *wb_context)
 	if (strategy_delta > 0 && recent_alloc > 0)
 	{
 		scans_per_alloc = (float) strategy_delta / (float) recent_alloc;
-		smoothed_density += (scans_per_alloc - smoothed_density) /
+		part->smoothed_density += (scans_per_alloc - part->smoothed_density) /
 			smoothing_samples;
 	}
 
@@ -3892,22 +4008,22 @@ BgBufferSync(WritebackContext *wb_context)
 	 * strategy point and where we've scanned ahead to, based on the smoothed
 	 * density estimate.
 	 */
-	bufs_ahead = NBuffers - bufs_to_lap;
-	reusable_buffers_est = (float) bufs_ahead / smoothed_density;
+	bufs_ahead = num_buffers - bufs_to_lap;
+	reusable_buffers_est = (float) bufs_ahead / part->smoothed_density;
 
 	/*
 	 * Track a moving average of recent buffer allocations.  Here, rather than
 	 * a true average we want a fast-attack, slow-decline behavior: we
 	 * immediately follow any increase.
 	 */
-	if (smoothed_alloc <= (float) recent_alloc)
-		smoothed_alloc = recent_alloc;
+	if (part->smoothed_alloc <= (float) recent_alloc)
+		part->smoothed_alloc = recent_alloc;
 	else
-		smoothed_alloc += ((float) recent_alloc - smoothed_alloc) /
+		part->smoothed_alloc += ((float) recent_alloc - part->smoothed_alloc) /
 			smoothing_samples;
 
 	/* Scale the estimate by a GUC to allow more aggressive tuning. */
-	upcoming_alloc_est = (int) (smoothed_alloc * bgwriter_lru_multiplier);
+	upcoming_alloc_est = (int) (part->smoothed_alloc * bgwriter_lru_multiplier);
 
 	/*
 	 * If recent_alloc remains at zero for many cycles, smoothed_alloc will
@@ -3918,7 +4034,7 @@ BgBufferSync(WritebackContext *wb_context)
 	 * syndrome.  It will pop back up as soon as recent_alloc increases.
 	 */
 	if (upcoming_alloc_est == 0)
-		smoothed_alloc = 0;
+		part->smoothed_alloc = 0;
 
 	/*
 	 * Even in cases where there's been little or no buffer allocation
@@ -3928,9 +4044,9 @@ BgBufferSync(WritebackContext *wb_context)
 	 *
 	 * (scan_whole_pool_milliseconds / BgWriterDelay) computes how many times
 	 * the BGW will be called during the scan_whole_pool time; slice the
-	 * buffer pool into that many sections.
+	 * partition into that many sections.
 	 */
-	min_scan_buffers = (int) (NBuffers / (scan_whole_pool_milliseconds / BgWriterDelay));
+	min_scan_buffers = (int) (num_buffers / (scan_whole_pool_milliseconds / BgWriterDelay));
 
 	if (upcoming_alloc_est < (min_scan_buffers + reusable_buffers_est))
 	{
@@ -3945,7 +4061,7 @@ BgBufferSync(WritebackContext *wb_context)
 	 * Now write out dirty reusable buffers, working forward from the
 	 * next_to_clean point, until we have lapped the strategy scan, or cleaned
 	 * enough buffers to match our estimate of the next cycle's allocation
-	 * requirements, or hit the bgwriter_lru_maxpages limit.
+	 * requirements, or hit the max_pages limit.
 	 */
 
 	num_to_scan = bufs_to_lap;
@@ -3955,22 +4071,22 @@ BgBufferSync(WritebackContext *wb_context)
 	/* Execute the LRU scan */
 	while (num_to_scan > 0 && reusable_buffers < upcoming_alloc_est)
 	{
-		int			sync_state = SyncOneBuffer(next_to_clean, true,
-											   wb_context);
+		int			sync_state = SyncOneBuffer(part->first_buffer + part->next_to_clean,
+											   true, wb_context);
 
-		if (++next_to_clean >= NBuffers)
+		if (++part->next_to_clean >= num_buffers)
 		{
-			next_to_clean = 0;
-			next_passes++;
+			part->next_to_clean = 0;
+			part->next_passes++;
 		}
 		num_to_scan--;
 
 		if (sync_state & BUF_WRITTEN)
 		{
 			reusable_buffers++;
-			if (++num_written >= bgwriter_lru_maxpages)
+			if (++num_written >= max_pages)
 			{
-				PendingBgWriterStats.maxwritten_clean++;
+				*hit_max_pages = true;
 				break;
 			}
 		}
@@ -3981,9 +4097,10 @@ BgBufferSync(WritebackContext *wb_context)
 	PendingBgWriterStats.buf_written_clean += num_written;
 
 #ifdef BGW_DEBUG
-	elog(DEBUG1, "bgwriter: recent_alloc=%u smoothed=%.2f delta=%ld ahead=%d density=%.2f reusable_est=%d upcoming_est=%d scanned=%d wrote=%d reusable=%d",
-		 recent_alloc, smoothed_alloc, strategy_delta, bufs_ahead,
-		 smoothed_density, reusable_buffers_est, upcoming_alloc_est,
+	elog(DEBUG1, "bgwriter: partition at %d: recent_alloc=%u smoothed=%.2f delta=%ld ahead=%d density=%.2f reusable_est=%d upcoming_est=%d scanned=%d wrote=%d reusable=%d",
+		 part->first_buffer,
+		 recent_alloc, part->smoothed_alloc, strategy_delta, bufs_ahead,
+		 part->smoothed_density, reusable_buffers_est, upcoming_alloc_est,
 		 bufs_to_lap - num_to_scan,
 		 num_written,
 		 reusable_buffers - reusable_buffers_est);
@@ -4002,13 +4119,13 @@ BgBufferSync(WritebackContext *wb_context)
 	if (new_strategy_delta > 0 && new_recent_alloc > 0)
 	{
 		scans_per_alloc = (float) new_strategy_delta / (float) new_recent_alloc;
-		smoothed_density += (scans_per_alloc - smoothed_density) /
+		part->smoothed_density += (scans_per_alloc - part->smoothed_density) /
 			smoothing_samples;
 
 #ifdef BGW_DEBUG
 		elog(DEBUG2, "bgwriter: cleaner density alloc=%u scan=%ld density=%.2f new smoothed=%.2f",
 			 new_recent_alloc, new_strategy_delta,
-			 scans_per_alloc, smoothed_density);
+			 scans_per_alloc, part->smoothed_density);
 #endif
 	}
 
@@ -4093,6 +4210,150 @@ SyncOneBuffer(int buf_id, bool skip_recently_used, WritebackContext *wb_context)
 	return result | BUF_WRITTEN;
 }
 
+/*
+ * CheckpointRunLength -- count writable neighbours of a checkpoint buffer.
+ *
+ * Returns how many of the sorted to-be-checkpointed buffers of the given
+ * tablespace, starting at its current position, hold consecutive blocks of
+ * the same relation fork, capped at io_combine_limit.  The sort items don't
+ * include the database OID, so this is only a hint; SyncBufferRun() checks
+ * the actual buffer tags.
+ */
+static int
+CheckpointRunLength(CkptTsStatus *ts_stat)
+{
+	CkptSortItem *first = &CkptBufferIds[ts_stat->index];
+	int			max_length;
+	int			length;
+
+	max_length = Min(io_combine_limit,
+					 ts_stat->num_to_scan - ts_stat->num_scanned);
+
+	for (length = 1; length < max_length; length++)
+	{
+		CkptSortItem *item = &first[length];
+
+		if (item->relNumber != first->relNumber ||
+			item->forkNum != first->forkNum ||
+			item->blockNum != first->blockNum + length)
+			break;
+	}
+
+	return length;
+}
+
+/*
+ * SyncBufferRun -- write a run of consecutive checkpoint buffers.
+ *
+ * This is the checkpointer's equivalent of calling SyncOneBuffer() for each
+ * of the nitems buffers described by items, which must be sorted and hold
+ * consecutive blocks, except that the pages are written out with a single
+ * smgrwritev() call.  The first buffer is locked and written even if that
+ * requires waiting, like SyncOneBuffer() would.  The run is cut short at the
+ * first following buffer that has been replaced, cleaned, or is locked or
+ * under I/O by someone else; we don't wait for those, to avoid holding the
+ * content locks of the buffers already collected for longer than necessary.
+ * The remaining buffers will be handled individually when BufferSync() gets
+ * to them.
+ *
+ * Returns the number of buffers written.
+ */
+static int
+SyncBufferRun(CkptSortItem *items, int nitems, WritebackContext *wb_context)
+{
+	BufferDesc *bufs[MAX_IO_COMBINE_LIMIT];
+	BufferTag	tag;
+	int			nbufs = 0;
+
+	Assert(nitems > 0 && nitems <= MAX_IO_COMBINE_LIMIT);
+
+	/*
+	 * Pin, share-lock and start I/O on as many buffers of the run as we can.
+	 */
+	for (int i = 0; i < nitems; i++)
+	{
+		BufferDesc *bufHdr = GetBufferDescriptor(items[i].buf_id);
+		Buffer		buffer = BufferDescriptorGetBuffer(bufHdr);
+		uint64		buf_state;
+
+		/* Make sure we can handle the pin */
+		ReservePrivateRefCountEntry();
+		ResourceOwnerEnlarge(CurrentResourceOwner);
+
+		buf_state = LockBufHdr(bufHdr);
+
+		if (i == 0)
+		{
+			if (!(buf_state & BM_VALID) || !(buf_state & BM_DIRTY))
+			{
+				UnlockBufHdr(bufHdr);
+				break;
+			}
+			tag = bufHdr->tag;
+		}
+		else
+		{
+			BufferTag	expected = tag;
+
+			expected.blockNum = tag.blockNum + i;
+			if (!(buf_state & BM_VALID) || !(buf_state & BM_DIRTY) ||
+				!(buf_state & BM_CHECKPOINT_NEEDED) ||
+				!BufferTagsEqual(&bufHdr->tag, &expected))
+			{
+				UnlockBufHdr(bufHdr);
+				break;
+			}
+		}
+
+		PinBuffer_Locked(bufHdr);
+
+		if (i == 0)
+			BufferLockAcquire(buffer, bufHdr, BUFFER_LOCK_SHARE);
+		else if (!BufferLockConditional(buffer, bufHdr, BUFFER_LOCK_SHARE))
+		{
+			UnpinBuffer(bufHdr);
+			break;
+		}
+
+		/*
+		 * As in FlushBuffer(), if StartBufferIO returns false, someone else
+		 * flushed the buffer before we could.
+		 */
+		if (!StartBufferIO(bufHdr, false, i > 0))
+		{
+			BufferLockUnlock(buffer, bufHdr);
+			UnpinBuffer(bufHdr);
+			break;
+		}
+
+		bufs[nbufs++] = bufHdr;
+	}
+
+	if (nbufs == 0)
+		return 0;
+
+	/*
+	 * SyncBufferRun() is only called by checkpointer, so IOContext will
+	 * always be IOCONTEXT_NORMAL.
+	 */
+	WriteBufferRun(bufs, nbufs, IOCONTEXT_NORMAL);
+
+	for (int i = 0; i < nbufs; i++)
+	{
+		BufferDesc *bufHdr = bufs[i];
+
+		TRACE_POSTGRESQL_BUFFER_SYNC_WRITTEN(items[i].buf_id);
+
+		tag = bufHdr->tag;
+		BufferLockUnlock(BufferDescriptorGetBuffer(bufHdr), bufHdr);
+		UnpinBuffer(bufHdr);
+
+		ScheduleBufferTagForWriteback(wb_context, IOCONTEXT_NORMAL, &tag);
+	}
+
+	return nbufs;
+}
+
 /*
  *		AtEOXact_Buffers - clean up at end of transaction.
  *
@@ -4561,6 +4822,221 @@ FlushUnlockedBuffer(BufferDesc *buf, SMgrRelation reln,
 	BufferLockUnlock(buffer, buf);
 }
 
+/*
+ * WriteBufferRun -- write out a run of buffers with a single I/O.
+ *
+ * This is FlushBuffer() for nbufs buffers holding consecutive blocks of the
+ * same relation fork, in block order.  The caller must have pinned and
+ * share-locked all of them, and successfully called StartBufferIO() on each.
+ * WAL is flushed once, up to the newest LSN among the pages, and the pages
+ * are passed to smgrwritev() together.  The I/O is counted as a single
+ * write in pg_stat_io, so the ratio of write_bytes to writes there shows how
+ * well writes are being combined.  On return the buffers are clean (unless
+ * redirtied meanwhile) and no longer I/O busy, but still pinned and locked.
+ */
+static void
+WriteBufferRun(BufferDesc **bufs, int nbufs, IOContext io_context)
+{
+	const void *pages[MAX_IO_COMBINE_LIMIT];
+	static char *pageCopies = NULL;
+	BufferTag	tag = bufs[0]->tag;
+	XLogRecPtr	max_lsn = InvalidXLogRecPtr;
+	ErrorContextCallback errcallback;
+	SMgrRelation reln;
+	instr_time	io_start;
+
+	Assert(nbufs > 0 && nbufs <= MAX_IO_COMBINE_LIMIT);
+
+	/* Setup error traceback support for ereport() */
+	errcallback.callback = shared_buffer_write_error_callback;
+	errcallback.arg = bufs[0];
+	errcallback.previous = error_context_stack;
+	error_context_stack = &errcallback;
+
+	reln = smgropen(BufTagGetRelFileLocator(&tag), INVALID_PROC_NUMBER);
+
+	/*
+	 * Collect the LSNs and clear BM_JUST_DIRTIED, as FlushBuffer() does, and
+	 * force WAL out far enough to cover all the pages of the run at once.
+	 */
+	for (int i = 0; i < nbufs; i++)
+	{
+		BufferDesc *bufHdr = bufs[i];
+		uint64		buf_state;
+		XLogRecPtr	recptr;
+
+		Assert(BufTagGetForkNum(&bufHdr->tag) == BufTagGetForkNum(&tag));
+		Assert(bufHdr->tag.blockNum == tag.blockNum + i);
+
+		TRACE_POSTGRESQL_BUFFER_FLUSH_START(BufTagGetForkNum(&tag),
+											bufHdr->tag.blockNum,
+											reln->smgr_rlocator.locator.spcOid,
+											reln->smgr_rlocator.locator.dbOid,
+											reln->smgr_rlocator.locator.relNumber);
+
+		buf_state = LockBufHdr(bufHdr);
+		recptr = BufferGetLSN(bufHdr);
+		UnlockBufHdrExt(bufHdr, buf_state,
+						0, BM_JUST_DIRTIED,
+						0);
+
+		if ((buf_state & BM_PERMANENT) && recptr > max_lsn)
+			max_lsn = recptr;
+	}
+
+	if (XLogRecPtrIsValid(max_lsn))
+		XLogFlush(max_lsn);
+
+	/*
+	 * We only hold share locks, so pages must be copied to private storage
+	 * before checksumming, as in PageSetChecksumCopy().  That function uses a
+	 * single static page though, so keep our own array of copies.
+	 */
+	if (DataChecksumsEnabled() && pageCopies == NULL)
+		pageCopies = MemoryContextAllocAligned(TopMemoryContext,
+											   MAX_IO_COMBINE_LIMIT * BLCKSZ,
+											   PG_IO_ALIGN_SIZE,
+											   0);
+
+	for (int i = 0; i < nbufs; i++)
+	{
+		Page		page = (Page) BufHdrGetBlock(bufs[i]);
+
+		if (DataChecksumsEnabled())
+		{
+			char	   *copy = pageCopies + i * BLCKSZ;
+
+			memcpy(copy, page, BLCKSZ);
+			PageSetChecksumInplace((Page) copy, tag.blockNum + i);
+			pages[i] = copy;
+		}
+		else
+			pages[i] = page;
+	}
+
+	io_start = pgstat_prepare_io_time(track_io_timing);
+
+	smgrwritev(reln, BufTagGetForkNum(&tag), tag.blockNum, pages, nbufs,
+			   false);
+
+	pgstat_count_io_op_time(IOOBJECT_RELATION, io_context,
+							IOOP_WRITE, io_start, 1, nbufs * BLCKSZ);
+
+	pgBufferUsage.shared_blks_written += nbufs;
+
+	for (int i = 0; i < nbufs; i++)
+	{
+		BufferDesc *bufHdr = bufs[i];
+
+		TerminateBufferIO(bufHdr, true, 0, true, false);
+
+		TRACE_POSTGRESQL_BUFFER_FLUSH_DONE(BufTagGetForkNum(&tag),
+										   tag.blockNum + i,
+										   reln->smgr_rlocator.locator.spcOid,
+										   reln->smgr_rlocator.locator.dbOid,
+										   reln->smgr_rlocator.locator.relNumber);
+	}
+
+	/* Pop the error context stack */
+	error_context_stack = errcallback.previous;
+}
+
+/*
+ * FlushStrategyRun -- flush a dirty strategy victim together with the
+ * buffers following it in the strategy ring.
+ *
+ * The victim must be pinned and share-locked by the caller.  Bulk operations
+ * like COPY usually fill their ring with consecutive blocks of the same
+ * relation, so the buffers the ring will hand out next often hold the blocks
+ * following the victim, and will have to be written out shortly anyway.
+ * Write as many of them as possible in the same I/O, up to io_combine_limit
+ * blocks.  A neighbor is only included if it is unpinned and dirty, and its
+ * content lock and I/O can be acquired without waiting.
+ *
+ * Returns the number of buffers written, or 0 if someone else flushed the
+ * victim before we could.  The victim stays pinned and locked; the
+ * neighbors are released and scheduled for writeback here.
+ */
+static int
+FlushStrategyRun(BufferAccessStrategy strategy, BufferDesc *victim,
+				 IOContext io_context)
+{
+	BufferDesc *bufs[MAX_IO_COMBINE_LIMIT];
+	BufferTag	tag = victim->tag;
+	int			nbufs = 0;
+
+	if (!StartBufferIO(victim, false, false))
+		return 0;
+	bufs[nbufs++] = victim;
+
+	while (nbufs < io_combine_limit)
+	{
+		Buffer		buffer = StrategyPeekRing(strategy, nbufs);
+		BufferDesc *bufHdr;
+		BufferTag	expected = tag;
+		uint64		buf_state;
+		XLogRecPtr	lsn;
+
+		if (buffer == InvalidBuffer)
+			break;
+		bufHdr = GetBufferDescriptor(buffer - 1);
+
+		/* Make sure we can handle the pin */
+		ReservePrivateRefCountEntry();
+		ResourceOwnerEnlarge(CurrentResourceOwner);
+
+		expected.blockNum = tag.blockNum + nbufs;
+		buf_state = LockBufHdr(bufHdr);
+		if (BUF_STATE_GET_REFCOUNT(buf_state) != 0 ||
+			!(buf_state & BM_VALID) || !(buf_state & BM_DIRTY) ||
+			!BufferTagsEqual(&bufHdr->tag, &expected))
+		{
+			UnlockBufHdr(bufHdr);
+			break;
+		}
+		lsn = BufferGetLSN(bufHdr);
+		PinBuffer_Locked(bufHdr);
+
+		/*
+		 * Like StrategyRejectBuffer(), don't let a bulk read flush WAL just
+		 * to write a neighbor.  Other strategies happily flush WAL for their
+		 * victims, and the neighbors will need it soon anyway.
+		 */
+		if ((io_context == IOCONTEXT_BULKREAD &&
+			 (buf_state & BM_PERMANENT) && XLogNeedsFlush(lsn)) ||
+			!BufferLockConditional(buffer, bufHdr, BUFFER_LOCK_SHARE))
+		{
+			UnpinBuffer(bufHdr);
+			break;
+		}
+
+		if (!StartBufferIO(bufHdr, false, true))
+		{
+			BufferLockUnlock(buffer, bufHdr);
+			UnpinBuffer(bufHdr);
+			break;
+		}
+
+		bufs[nbufs++] = bufHdr;
+	}
+
+	WriteBufferRun(bufs, nbufs, io_context);
+
+	for (int i = 1; i < nbufs; i++)
+	{
+		BufferDesc *bufHdr = bufs[i];
+
+		tag = bufHdr->tag;
+		BufferLockUnlock(BufferDescriptorGetBuffer(bufHdr), bufHdr);
+		UnpinBuffer(bufHdr);
+
+		ScheduleBufferTagForWriteback(&BackendWritebackContext, io_context,
+									  &tag);
+	}
+
+	return nbufs;
+}
+
 /*
  * RelationGetNumberOfBlocksInFork
  *		Determines the current number of pages in the specified relation fork.
@@ -15,27 +15,67 @@
  */
 #include "postgres.h"
 
+#include <unistd.h>
+
 #include "pgstat.h"
 #include "port/atomics.h"
+#include "port/pg_numa.h"
 #include "storage/buf_internals.h"
 #include "storage/bufmgr.h"
+#include "storage/pg_shmem.h"
 #include "storage/proc.h"
 
 #define INT_ACCESS_ONCE(var)	((int)(*((volatile int *)&(var))))
 
+/* Don't let clock-sweep partitions get too small to be useful */
+#define MIN_BUFFERS_PER_PARTITION	1024
 
 /*
- * The shared freelist control information.
+ * Don't bother redirecting allocations away from a partition unless its
+ * share of the allocations exceeds its share of the buffers by more than
+ * this many percent.
  */
-typedef struct
+#define PARTITION_BALANCE_THRESHOLD	10
+
+/* Packing of ClockSweepPartition.balance */
+#define PARTITION_BALANCE(target, percent)	(((uint32) (target) << 8) | (percent))
+#define PARTITION_BALANCE_TARGET(balance)	((int) ((balance) >> 8))
+#define PARTITION_BALANCE_PERCENT(balance)	((uint32) ((balance) & 0xFF))
+
+
+/*
+ * A partition of the clock sweep.
+ *
+ * The buffer pool is divided into clock_sweep_partitions contiguous ranges
+ * of buffers, each with its own clock hand.  A backend normally only sweeps
+ * its "home" partition, so that concurrent evictions in different backends
+ * don't all hammer the very same atomic counter.
+ *
+ * Backends aren't necessarily spread evenly over the partitions, nor do they
+ * all allocate buffers at the same rate, so the bgwriter periodically
+ * compares the allocations requested by the backends whose home each
+ * partition is with its share of the buffers; see
+ * StrategyBalancePartitions().  A fraction of the allocations of a partition
+ * with more than its share is then redirected to a partition with less,
+ * so that all of the buffer pool is cycled through at about the same rate.
+ */
+typedef struct ClockSweepPartition
 {
-	/* Spinlock: protects the values below */
-	slock_t		buffer_strategy_lock;
+	/* Spinlock: protects completePasses and totalBufferAllocs */
+	slock_t		lock;
+
+	/* range of buffer ids belonging to this partition */
+	int			firstBuffer;
+	int			numBuffers;
+
+	/* NUMA node the partition's memory is placed on, or -1 */
+	int			numaNode;
 
 	/*
-	 * clock-sweep hand: index of next buffer to consider grabbing. Note that
-	 * this isn't a concrete buffer - we only ever increase the value. So, to
-	 * get an actual buffer, it needs to be used modulo NBuffers.
+	 * clock-sweep hand: index, relative to firstBuffer, of next buffer to
+	 * consider grabbing. Note that this isn't a concrete buffer - we only
+	 * ever increase the value. So, to get an actual buffer, it needs to be
+	 * used modulo numBuffers.
 	 */
 	pg_atomic_uint32 nextVictimBuffer;
 
@@ -46,6 +86,56 @@ typedef struct
 	uint32		completePasses; /* Complete cycles of the clock-sweep */
 	pg_atomic_uint32 numBufferAllocs;	/* Buffers allocated since last reset */
 
+	/* Buffer allocations already collected by StrategySyncStart() */
+	uint64		totalBufferAllocs;
+
+	/* Allocations redirected to another partition since last reset */
+	pg_atomic_uint32 numRedirected;
+
+	/*
+	 * Where to redirect allocations requested by backends whose home this
+	 * partition is: the target partition and the percentage of allocations
+	 * to redirect, packed with PARTITION_BALANCE().  Zero if none.  Set by
+	 * the bgwriter in StrategyBalancePartitions().
+	 */
+	pg_atomic_uint32 balance;
+
+	/*
+	 * Allocations and redirections collected by the last call of
+	 * StrategySyncStart() for this partition, for the use of
+	 * StrategyBalancePartitions().  Only accessed by the bgwriter.
+	 */
+	uint32		recentAllocs;
+	uint32		recentRedirected;
+} ClockSweepPartition;
+
+/*
+ * Pad each partition to a full cache line, so that sweeping one partition
+ * doesn't cause cache line contention with backends sweeping another.
+ */
+typedef union ClockSweepPartitionPadded
+{
+	ClockSweepPartition part;
+	char		pad[PG_CACHE_LINE_SIZE];
+} ClockSweepPartitionPadded;
+
+/*
+ * The shared freelist control information.
+ */
+typedef struct
+{
+	/* Spinlock: protects bgwprocno */
+	slock_t		buffer_strategy_lock;
+
+	/* Number of elements in the ClockSweepPartitions array; constant */
+	int			numPartitions;
+
+	/*
+	 * Number of NUMA nodes the partitions are spread over, or 0 if they are
+	 * not NUMA-aware.  Partition i is placed on node (i % numaNodes).
+	 */
+	int			numaNodes;
+
 	/*
 	 * Bgworker process to be notified upon activity or -1 if none. See
 	 * StrategyNotifyBgWriter.
@@ -53,8 +143,19 @@ typedef struct
 	int			bgwprocno;
 } BufferStrategyControl;
 
+/* GUC variables */
+int			clock_sweep_partitions = 1;
+bool		shared_buffers_numa = false;
+
+/* NUMA node this backend was running on when it first allocated a buffer */
+static int	MyNumaNode = -2;
+
+/* Number of buffers this backend has allocated with the clock sweep */
+static uint32 MyClockSweepAllocs = 0;
+
 /* Pointers to shared state */
 static BufferStrategyControl *StrategyControl = NULL;
+static ClockSweepPartitionPadded *ClockSweepPartitions = NULL;
 
 /*
  * Private (non-shared) state for managing a ring of shared buffers to re-use.
@@ -93,11 +194,11 @@ static void AddBufferToRing(BufferAccessStrategy strategy,
 /*
  * ClockSweepTick - Helper routine for StrategyGetBuffer()
  *
- * Move the clock hand one buffer ahead of its current position and return the
- * id of the buffer now under the hand.
+ * Move the clock hand of the given partition one buffer ahead of its current
+ * position and return the id of the buffer now under the hand.
  */
 static inline uint32
-ClockSweepTick(void)
+ClockSweepTick(ClockSweepPartition *part)
 {
 	uint32		victim;
 
@@ -107,14 +208,14 @@ ClockSweepTick(void)
 	 * apparent order.
 	 */
 	victim =
-		pg_atomic_fetch_add_u32(&StrategyControl->nextVictimBuffer, 1);
+		pg_atomic_fetch_add_u32(&part->nextVictimBuffer, 1);
 
-	if (victim >= NBuffers)
+	if (victim >= part->numBuffers)
 	{
 		uint32		originalVictim = victim;
 
 		/* always wrap what we look up in BufferDescriptors */
-		victim = victim % NBuffers;
+		victim = victim % part->numBuffers;
 
 		/*
 		 * If we're the one that just caused a wraparound, force
@@ -140,19 +241,57 @@ ClockSweepTick(void)
 				 * could lead to an overflow of nextVictimBuffers, but that's
 				 * highly unlikely and wouldn't be particularly harmful.
 				 */
-				SpinLockAcquire(&StrategyControl->buffer_strategy_lock);
+				SpinLockAcquire(&part->lock);
 
-				wrapped = expected % NBuffers;
+				wrapped = expected % part->numBuffers;
 
-				success = pg_atomic_compare_exchange_u32(&StrategyControl->nextVictimBuffer,
+				success = pg_atomic_compare_exchange_u32(&part->nextVictimBuffer,
 														 &expected, wrapped);
 				if (success)
-					StrategyControl->completePasses++;
-				SpinLockRelease(&StrategyControl->buffer_strategy_lock);
+					part->completePasses++;
+				SpinLockRelease(&part->lock);
 			}
 		}
 	}
-	return victim;
+	return part->firstBuffer + victim;
+}
+
+/*
+ * ClockSweepHomePartition - Select the partition this backend sweeps first
+ *
+ * Backends are spread over the partitions by their proc number, which keeps
+ * the assignment stable for the lifetime of the backend.
+ */
+static inline int
+ClockSweepHomePartition(void)
+{
+	int			numaNodes = StrategyControl->numaNodes;
+	int			procno = Max(MyProcNumber, 0);
+
+	if (StrategyControl->numPartitions == 1)
+		return 0;
+
+	/*
+	 * With NUMA-aware partitions, prefer a partition whose memory is on the
+	 * node we're running on, so that the pages we read in end up in local
+	 * memory.  We only look up the node once; the scheduler usually keeps a
+	 * process on the same node, and if it doesn't, we're merely less
+	 * efficient.
+	 */
+	if (numaNodes > 0)
+	{
+		if (unlikely(MyNumaNode == -2))
+			MyNumaNode = pg_numa_get_current_node();
+
+		if (MyNumaNode >= 0)
+		{
+			int			perNode = StrategyControl->numPartitions / numaNodes;
+
+			return (MyNumaNode % numaNodes) + numaNodes * (procno % perNode);
+		}
+	}
+
+	return procno % StrategyControl->numPartitions;
 }
 
 /*
@@ -175,7 +314,11 @@ StrategyGetBuffer(BufferAccessStrategy strategy, uint64 *buf_state, bool *from_r
 {
 	BufferDesc *buf;
 	int			bgwprocno;
+	int			partno;
+	ClockSweepPartition *part;
+	uint32		balance;
 	int			trycounter;
+	int			exhausted;
 
 	*from_ring = false;
 
@@ -219,21 +362,45 @@ StrategyGetBuffer(BufferAccessStrategy strategy, uint64 *buf_state, bool *from_r
 		SetLatch(&GetPGProcByNumber(bgwprocno)->procLatch);
 	}
 
+	partno = ClockSweepHomePartition();
+	part = &ClockSweepPartitions[partno].part;
+
+	/*
+	 * If our home partition is getting more than its share of allocations,
+	 * serve the requested percentage of our allocations from the partition
+	 * the bgwriter picked instead.  Counting our own allocations spreads
+	 * those evenly, without the cost of a random number.
+	 */
+	balance = pg_atomic_read_u32(&part->balance);
+	if (balance != 0 &&
+		MyClockSweepAllocs++ % 100 < PARTITION_BALANCE_PERCENT(balance))
+	{
+		pg_atomic_fetch_add_u32(&part->numRedirected, 1);
+
+		partno = PARTITION_BALANCE_TARGET(balance);
+		part = &ClockSweepPartitions[partno].part;
+	}
+
 	/*
 	 * We count buffer allocation requests so that the bgwriter can estimate
-	 * the rate of buffer consumption.  Note that buffers recycled by a
-	 * strategy object are intentionally not counted here.
+	 * the rate of buffer consumption in each partition.  Note that buffers
+	 * recycled by a strategy object are intentionally not counted here.
 	 */
-	pg_atomic_fetch_add_u32(&StrategyControl->numBufferAllocs, 1);
+	pg_atomic_fetch_add_u32(&part->numBufferAllocs, 1);
 
-	/* Use the "clock sweep" algorithm to find a free buffer */
-	trycounter = NBuffers;
+	/*
+	 * Use the "clock sweep" algorithm to find a free buffer, starting with
+	 * our home partition.  If all the buffers in a partition turn out to be
+	 * pinned, move on to the next one.
+	 */
+	trycounter = part->numBuffers;
+	exhausted = 0;
 	for (;;)
 	{
 		uint64		old_buf_state;
 		uint64		local_buf_state;
 
-		buf = GetBufferDescriptor(ClockSweepTick());
+		buf = GetBufferDescriptor(ClockSweepTick(part));
 
 		/*
 		 * Check whether the buffer can be used and pin it if so. Do this
@@ -255,13 +422,20 @@ StrategyGetBuffer(BufferAccessStrategy strategy, uint64 *buf_state, bool *from_r
 				if (--trycounter == 0)
 				{
 					/*
-					 * We've scanned all the buffers without making any state
-					 * changes, so all the buffers are pinned (or were when we
-					 * looked at them). We could hope that someone will free
-					 * one eventually, but it's probably better to fail than
-					 * to risk getting stuck in an infinite loop.
+					 * We've scanned all the buffers of this partition without
+					 * making any state changes, so try the next partition.
+					 * If all the partitions are exhausted, all the buffers
+					 * are pinned (or were when we looked at them). We could
+					 * hope that someone will free one eventually, but it's
+					 * probably better to fail than to risk getting stuck in
+					 * an infinite loop.
 					 */
-					elog(ERROR, "no unpinned buffers available");
+					if (++exhausted >= StrategyControl->numPartitions)
+						elog(ERROR, "no unpinned buffers available");
+
+					partno = (partno + 1) % StrategyControl->numPartitions;
+					part = &ClockSweepPartitions[partno].part;
+					trycounter = part->numBuffers;
 				}
 				break;
 			}
@@ -280,7 +454,8 @@ StrategyGetBuffer(BufferAccessStrategy strategy, uint64 *buf_state, bool *from_r
 				if (pg_atomic_compare_exchange_u64(&buf->state, &old_buf_state,
 												   local_buf_state))
 				{
-					trycounter = NBuffers;
+					trycounter = part->numBuffers;
+					exhausted = 0;
 					break;
 				}
 			}
@@ -307,10 +482,12 @@ StrategyGetBuffer(BufferAccessStrategy strategy, uint64 *buf_state, bool *from_r
 }
 
 /*
- * StrategySyncStart -- tell BgBufferSync where to start syncing
+ * StrategySyncStart -- tell BgBufferSync where to start syncing a partition
  *
- * The result is the buffer index of the best buffer to sync first.
- * BgBufferSync() will proceed circularly around the buffer array from there.
+ * The result is the index, relative to the start of clock-sweep partition
+ * partno, of the best buffer to sync first.  BgBufferSync() will proceed
+ * circularly around the partition's buffers from there.  The partition's
+ * range of buffers is returned in *first_buffer and *num_buffers.
  *
  * In addition, we return the completed-pass count (which is effectively
  * the higher-order bits of nextVictimBuffer) and the count of recent buffer
@@ -318,34 +495,190 @@ StrategyGetBuffer(BufferAccessStrategy strategy, uint64 *buf_state, bool *from_r
  * being read.
  */
 int
-StrategySyncStart(uint32 *complete_passes, uint32 *num_buf_alloc)
+StrategySyncStart(int partno, int *first_buffer, int *num_buffers,
+				  uint32 *complete_passes, uint32 *num_buf_alloc)
 {
+	ClockSweepPartition *part;
 	uint32		nextVictimBuffer;
 	int			result;
 
-	SpinLockAcquire(&StrategyControl->buffer_strategy_lock);
-	nextVictimBuffer = pg_atomic_read_u32(&StrategyControl->nextVictimBuffer);
-	result = nextVictimBuffer % NBuffers;
+	Assert(partno >= 0 && partno < StrategyControl->numPartitions);
+	part = &ClockSweepPartitions[partno].part;
+
+	*first_buffer = part->firstBuffer;
+	*num_buffers = part->numBuffers;
+
+	SpinLockAcquire(&part->lock);
+	nextVictimBuffer = pg_atomic_read_u32(&part->nextVictimBuffer);
+	result = nextVictimBuffer % part->numBuffers;
 
 	if (complete_passes)
 	{
-		*complete_passes = StrategyControl->completePasses;
+		*complete_passes = part->completePasses;
 
 		/*
 		 * Additionally add the number of wraparounds that happened before
 		 * completePasses could be incremented. C.f. ClockSweepTick().
 		 */
-		*complete_passes += nextVictimBuffer / NBuffers;
+		*complete_passes += nextVictimBuffer / part->numBuffers;
 	}
 
 	if (num_buf_alloc)
 	{
-		*num_buf_alloc = pg_atomic_exchange_u32(&StrategyControl->numBufferAllocs, 0);
+		part->recentAllocs = pg_atomic_exchange_u32(&part->numBufferAllocs, 0);
+		part->recentRedirected = pg_atomic_exchange_u32(&part->numRedirected, 0);
+		part->totalBufferAllocs += part->recentAllocs;
+		*num_buf_alloc = part->recentAllocs;
 	}
-	SpinLockRelease(&StrategyControl->buffer_strategy_lock);
+	SpinLockRelease(&part->lock);
+
 	return result;
 }
 
+/*
+ * StrategyBalancePartitions -- redirect allocations between partitions
+ *
+ * Called by the bgwriter after it has collected the recent allocation
+ * counts of all the partitions with StrategySyncStart().  We work out how
+ * many allocations the backends whose home each partition is requested,
+ * and compare that with the partition's share of the buffers.  Each
+ * partition with too many is then told to redirect its excess to the
+ * partition that is most short of allocations, as far as that one can take
+ * them.  A single target per partition is cruder than spreading the excess
+ * over all the partitions that could take some, but it only needs one word
+ * of state that backends can read without locking, and the balance is
+ * recomputed on every bgwriter cycle anyway.
+ */
+void
+StrategyBalancePartitions(void)
+{
+	int			numPartitions = StrategyControl->numPartitions;
+	double	   *requested;
+	double	   *deficit;
+	double		total = 0;
+
+	if (numPartitions == 1)
+		return;
+
+	requested = palloc_array(double, numPartitions);
+	deficit = palloc_array(double, numPartitions);
+
+	/*
+	 * The allocations served by a partition include those redirected to it
+	 * by other partitions, so subtract those and add back the ones it
+	 * redirected itself.  The balance may have changed while the counts
+	 * were being collected, so this is only an estimate.
+	 */
+	for (int i = 0; i < numPartitions; i++)
+		requested[i] = ClockSweepPartitions[i].part.recentAllocs;
+	for (int i = 0; i < numPartitions; i++)
+	{
+		ClockSweepPartition *part = &ClockSweepPartitions[i].part;
+		uint32		balance = pg_atomic_read_u32(&part->balance);
+
+		if (balance != 0)
+		{
+			requested[PARTITION_BALANCE_TARGET(balance)] -= part->recentRedirected;
+			requested[i] += part->recentRedirected;
+		}
+	}
+	for (int i = 0; i < numPartitions; i++)
+	{
+		requested[i] = Max(requested[i], 0);
+		total += requested[i];
+	}
+
+	/* Without any recent allocations, stick with what we had */
+	if (total == 0)
+	{
+		pfree(requested);
+		pfree(deficit);
+		return;
+	}
+
+	for (int i = 0; i < numPartitions; i++)
+	{
+		ClockSweepPartition *part = &ClockSweepPartitions[i].part;
+		double		expected = total * part->numBuffers / NBuffers;
+
+		deficit[i] = expected - requested[i];
+	}
+
+	for (int i = 0; i < numPartitions; i++)
+	{
+		ClockSweepPartition *part = &ClockSweepPartitions[i].part;
+		double		expected = total * part->numBuffers / NBuffers;
+		double		excess = -deficit[i];
+		uint32		balance = 0;
+		int			target = -1;
+
+		if (excess > expected * PARTITION_BALANCE_THRESHOLD / 100)
+		{
+			for (int j = 0; j < numPartitions; j++)
+			{
+				if (deficit[j] > 0 && (target < 0 || deficit[j] > deficit[target]))
+					target = j;
+			}
+		}
+
+		if (target >= 0)
+		{
+			double		moved = Min(excess, deficit[target]);
+			uint32		percent = (uint32) (moved * 100 / requested[i]);
+
+			if (percent > 0)
+			{
+				balance = PARTITION_BALANCE(target, Min(percent, 100));
+				deficit[target] -= moved;
+			}
+		}
+
+		pg_atomic_write_u32(&part->balance, balance);
+	}
+
+	pfree(requested);
+	pfree(deficit);
+}
+
+/*
+ * StrategyNumPartitions -- number of clock-sweep partitions
+ */
+int
+StrategyNumPartitions(void)
+{
+	return StrategyControl->numPartitions;
+}
+
+/*
+ * StrategyGetPartitionInfo -- report the state of a clock-sweep partition
+ *
+ * This is meant for monitoring, so the values may be slightly inconsistent
+ * with each other if buffers are being allocated concurrently.
+ */
+void
+StrategyGetPartitionInfo(int partno, int *first_buffer, int *num_buffers,
+						 int *numa_node, uint32 *next_victim_buffer,
+						 uint32 *complete_passes, uint64 *buffer_allocs)
+{
+	ClockSweepPartition *part;
+	uint32		nextVictimBuffer;
+
+	Assert(partno >= 0 && partno < StrategyControl->numPartitions);
+	part = &ClockSweepPartitions[partno].part;
+
+	*first_buffer = part->firstBuffer;
+	*num_buffers = part->numBuffers;
+	*numa_node = part->numaNode;
+
+	SpinLockAcquire(&part->lock);
+	nextVictimBuffer = pg_atomic_read_u32(&part->nextVictimBuffer);
+	*next_victim_buffer = part->firstBuffer + nextVictimBuffer % part->numBuffers;
+	*complete_passes = part->completePasses + nextVictimBuffer / part->numBuffers;
+	*buffer_allocs = part->totalBufferAllocs +
+		pg_atomic_read_u32(&part->numBufferAllocs);
+	SpinLockRelease(&part->lock);
+}
+
 /*
  * StrategyNotifyBgWriter -- set or clear allocation notification latch
  *
@@ -368,6 +701,83 @@ StrategyNotifyBgWriter(int bgwprocno)
 }
 
 
+/*
+ * ClockSweepNumaNodes -- number of NUMA nodes to spread partitions over
+ *
+ * Returns 0 if the partitions are not to be NUMA-aware, either because
+ * shared_buffers_numa is off or because NUMA isn't usable.
+ */
+static int
+ClockSweepNumaNodes(void)
+{
+	int			nodes;
+
+	if (!shared_buffers_numa || pg_numa_init() == -1)
+		return 0;
+
+	nodes = pg_numa_get_max_node() + 1;
+
+	/* no point on a single node, nor if each node can't get a partition */
+	if (nodes < 2 || NBuffers / MIN_BUFFERS_PER_PARTITION < nodes)
+		return 0;
+
+	return nodes;
+}
+
+/*
+ * ClockSweepNumPartitions -- number of clock-sweep partitions to create
+ *
+ * Every partition is given at least MIN_BUFFERS_PER_PARTITION buffers, so
+ * with a small shared_buffers we may use fewer partitions than requested.
+ * With NUMA-aware partitions, the number is a multiple of the number of
+ * nodes, so that every node has the same number of partitions.
+ */
+static int
+ClockSweepNumPartitions(void)
+{
+	int			maxPartitions = Max(NBuffers / MIN_BUFFERS_PER_PARTITION, 1);
+	int			numaNodes = ClockSweepNumaNodes();
+	int			numPartitions;
+
+	numPartitions = Min(clock_sweep_partitions, maxPartitions);
+
+	if (numaNodes > 0)
+	{
+		numPartitions = Max(numPartitions, numaNodes);
+		numPartitions -= numPartitions % numaNodes;
+	}
+
+	return numPartitions;
+}
+
+/*
+ * ClockSweepPlaceMemory -- place a range of shared memory on a NUMA node
+ *
+ * The range is shrunk to whole memory pages; pages straddling partition
+ * boundaries are left wherever the kernel puts them.
+ */
+static void
+ClockSweepPlaceMemory(char *start, Size size, int node)
+{
+	Size		pagesize = sysconf(_SC_PAGESIZE);
+	char	   *alignedStart;
+	char	   *alignedEnd;
+
+	if (huge_pages_status == HUGE_PAGES_ON)
+		GetHugePageSize(&pagesize, NULL);
+
+	alignedStart = (char *) TYPEALIGN(pagesize, start);
+	alignedEnd = (char *) TYPEALIGN_DOWN(pagesize, start + size);
+
+	if (alignedEnd <= alignedStart)
+		return;
+
+	if (pg_numa_prefer_node(alignedStart, alignedEnd - alignedStart, node) != 0)
+		ereport(WARNING,
+				(errmsg("could not place shared buffers on NUMA node %d: %m",
+						node)));
+}
+
 /*
  * StrategyShmemSize
  *
@@ -387,6 +797,10 @@ StrategyShmemSize(void)
 	/* size of the shared replacement strategy control block */
 	size = add_size(size, MAXALIGN(sizeof(BufferStrategyControl)));
 
+	/* size of the clock-sweep partitions */
+	size = add_size(size, mul_size(ClockSweepNumPartitions(),
+								   sizeof(ClockSweepPartitionPadded)));
+
 	return size;
 }
 
@@ -401,6 +815,8 @@ void
 StrategyInitialize(bool init)
 {
 	bool		found;
+	bool		foundPartitions;
+	int			numPartitions;
 
 	/*
 	 * Initialize the shared buffer lookup hashtable.
@@ -422,21 +838,73 @@ StrategyInitialize(bool init)
 						sizeof(BufferStrategyControl),
 						&found);
 
-	if (!found)
+	numPartitions = ClockSweepNumPartitions();
+	ClockSweepPartitions = (ClockSweepPartitionPadded *)
+		ShmemInitStruct("Buffer Strategy Partitions",
+						numPartitions * sizeof(ClockSweepPartitionPadded),
+						&foundPartitions);
+
+	if (!found || !foundPartitions)
 	{
+		int			partsize = NBuffers / numPartitions;
+
 		/*
 		 * Only done once, usually in postmaster
 		 */
 		Assert(init);
+		Assert(!found && !foundPartitions);
 
 		SpinLockInit(&StrategyControl->buffer_strategy_lock);
+		StrategyControl->numPartitions = numPartitions;
+		StrategyControl->numaNodes = ClockSweepNumaNodes();
+
+		/*
+		 * Divide the buffers into equally sized partitions, with the last one
+		 * taking any remainder.
+		 */
+		for (int i = 0; i < numPartitions; i++)
+		{
+			ClockSweepPartition *part = &ClockSweepPartitions[i].part;
+
+			SpinLockInit(&part->lock);
+			part->firstBuffer = i * partsize;
+			if (i == numPartitions - 1)
+				part->numBuffers = NBuffers - part->firstBuffer;
+			else
+				part->numBuffers = partsize;
 
-		/* Initialize the clock-sweep pointer */
-		pg_atomic_init_u32(&StrategyControl->nextVictimBuffer, 0);
+			/*
+			 * Place the partition's buffers and descriptors on its NUMA node.
+			 * The buffer blocks haven't been touched yet, but the descriptors
+			 * have already been initialized and are migrated.
+			 */
+			if (StrategyControl->numaNodes > 0)
+			{
+				part->numaNode = i % StrategyControl->numaNodes;
+				ClockSweepPlaceMemory(BufferBlocks + (Size) part->firstBuffer * BLCKSZ,
+									  (Size) part->numBuffers * BLCKSZ,
+									  part->numaNode);
+				ClockSweepPlaceMemory((char *) GetBufferDescriptor(part->firstBuffer),
+									  part->numBuffers * sizeof(BufferDescPadded),
+									  part->numaNode);
+			}
+			else
+				part->numaNode = -1;
 
-		/* Clear statistics */
-		StrategyControl->completePasses = 0;
-		pg_atomic_init_u32(&StrategyControl->numBufferAllocs, 0);
+			/* Initialize the clock-sweep pointer */
+			pg_atomic_init_u32(&part->nextVictimBuffer, 0);
+
+			/* Clear statistics */
+			part->completePasses = 0;
+			pg_atomic_init_u32(&part->numBufferAllocs, 0);
+			part->totalBufferAllocs = 0;
+
+			/* Not redirecting any allocations yet */
+			pg_atomic_init_u32(&part->numRedirected, 0);
+			pg_atomic_init_u32(&part->balance, 0);
+			part->recentAllocs = 0;
+			part->recentRedirected = 0;
+		}
 
 		/* No pending notification */
 		StrategyControl->bgwprocno = -1;
@@ -739,6 +1207,25 @@ AddBufferToRing(BufferAccessStrategy strategy, BufferDesc *buf)
 	strategy->buffers[strategy->current] = BufferDescriptorGetBuffer(buf);
 }
 
+/*
+ * StrategyPeekRing -- look ahead in a strategy's ring
+ *
+ * Returns the buffer in the ring slot "offset" slots after the current one,
+ * ie. the one that GetBufferFromRing will consider offset calls from now, or
+ * InvalidBuffer if that slot hasn't been filled yet.  The buffer is neither
+ * pinned nor locked, so the caller must recheck its state.
+ */
+Buffer
+StrategyPeekRing(BufferAccessStrategy strategy, int offset)
+{
+	Assert(offset > 0);
+
+	if (offset >= strategy->nbuffers)
+		return InvalidBuffer;
+
+	return strategy->buffers[(strategy->current + offset) % strategy->nbuffers];
+}
+
 /*
  * Utility function returning the IOContext of a given BufferAccessStrategy's
  * strategy ring.
@@ -40,18 +40,29 @@
  * when the corresponding files need to be survived across the transaction and
  * need to be opened and closed multiple times.  Such files need to be created
  * as a member of a FileSet.
+ *
+ * Private temporary files that are written sequentially, rewound and then
+ * read back sequentially (such as hash join batch files) can optionally be
+ * compressed; see BufFileCreateCompressTemp.  Each buffer is then written as
+ * a separately compressed block, preceded by a BufFileBlockHeader.
  *-------------------------------------------------------------------------
  */
 
 #include "postgres.h"
 
+#ifdef USE_LZ4
+#include <lz4.h>
+#endif
+
 #include "commands/tablespace.h"
+#include "common/pg_lzcompress.h"
 #include "executor/instrument.h"
 #include "miscadmin.h"
 #include "pgstat.h"
 #include "storage/buffile.h"
 #include "storage/bufmgr.h"
 #include "storage/fd.h"
+#include "utils/memutils.h"
 #include "utils/resowner.h"
 
 /*
@@ -62,6 +73,36 @@
 #define MAX_PHYSICAL_FILESIZE	0x40000000
 #define BUFFILE_SEG_SIZE		(MAX_PHYSICAL_FILESIZE / BLCKSZ)
 
+/*
+ * Header preceding each block of a compressed BufFile.  If len == rawlen,
+ * the block is stored uncompressed (because compression did not help).
+ */
+typedef struct BufFileBlockHeader
+{
+	int32		len;			/* length of the data that follows */
+	int32		rawlen;			/* length of the data once decompressed */
+} BufFileBlockHeader;
+
+#ifdef USE_LZ4
+#define BUFFILE_COMPRESS_BOUND \
+	Max(PGLZ_MAX_OUTPUT(BLCKSZ), LZ4_COMPRESSBOUND(BLCKSZ))
+#else
+#define BUFFILE_COMPRESS_BOUND	PGLZ_MAX_OUTPUT(BLCKSZ)
+#endif
+
+#define BUFFILE_COMPRESS_BUFSIZE \
+	(sizeof(BufFileBlockHeader) + BUFFILE_COMPRESS_BOUND)
+
+/* GUC variable */
+int			temp_file_compression = TEMP_FILE_COMPRESSION_OFF;
+
+/*
+ * Scratch space for compressing and decompressing blocks.  Since a block is
+ * always compressed or decompressed in one go, one buffer per backend is
+ * enough.
+ */
+static char *compress_buffer = NULL;
+
 /*
  * This data structure represents a buffered file that consists of one or
  * more physical files (each accessed through a virtual file descriptor
@@ -76,6 +117,7 @@ struct BufFile
 	bool		isInterXact;	/* keep open over transactions? */
 	bool		dirty;			/* does buffer need to be written? */
 	bool		readOnly;		/* has the file been set to read only? */
+	int			compress;		/* TEMP_FILE_COMPRESSION_xxx method */
 
 	FileSet    *fileset;		/* space for fileset based segment files */
 	const char *name;			/* name of fileset based BufFile */
@@ -107,7 +149,9 @@ static BufFile *makeBufFileCommon(int nfiles);
 static BufFile *makeBufFile(File firstfile);
 static void extendBufFile(BufFile *file);
 static void BufFileLoadBuffer(BufFile *file);
+static size_t BufFileReadRaw(BufFile *file, char *ptr, size_t size);
 static void BufFileDumpBuffer(BufFile *file);
+static void BufFileWriteRaw(BufFile *file, const char *ptr, int64 size);
 static void BufFileFlush(BufFile *file);
 static File MakeNewFileSetSegment(BufFile *buffile, int segment);
 
@@ -122,6 +166,7 @@ makeBufFileCommon(int nfiles)
 	file->numFiles = nfiles;
 	file->isInterXact = false;
 	file->dirty = false;
+	file->compress = TEMP_FILE_COMPRESSION_OFF;
 	file->resowner = CurrentResourceOwner;
 	file->curFile = 0;
 	file->curOffset = 0;
@@ -215,6 +260,33 @@ BufFileCreateTemp(bool interXact)
 	return file;
 }
 
+/*
+ * Create a BufFile for a new temporary file, like BufFileCreateTemp, whose
+ * contents are compressed with the method selected by temp_file_compression.
+ *
+ * A compressed file only supports being written sequentially, rewound and
+ * then read sequentially; it cannot be written again after that.  The only
+ * seek BufFileSeek accepts on such a file is (0, 0, SEEK_SET), the rewind;
+ * any other position raises an error, since block boundaries in the
+ * compressed file don't correspond to logical offsets.  BufFileTell,
+ * BufFileSeekBlock and BufFileSize do not return meaningful results.
+ */
+BufFile *
+BufFileCreateCompressTemp(bool interXact)
+{
+	BufFile    *file = BufFileCreateTemp(interXact);
+
+	if (temp_file_compression != TEMP_FILE_COMPRESSION_OFF)
+	{
+		if (compress_buffer == NULL)
+			compress_buffer = MemoryContextAlloc(TopMemoryContext,
+												 BUFFILE_COMPRESS_BUFSIZE);
+		file->compress = temp_file_compression;
+	}
+
+	return file;
+}
+
 /*
  * Build the name for a given segment of a given BufFile.
  */
@@ -437,6 +509,57 @@ BufFileLoadBuffer(BufFile *file)
 	instr_time	io_start;
 	instr_time	io_time;
 
+	if (file->compress != TEMP_FILE_COMPRESSION_OFF)
+	{
+		BufFileBlockHeader hdr;
+		char	   *data;
+		size_t		nread;
+		int32		rawlen;
+
+		/*
+		 * Read the next block's header and data, advancing curOffset past
+		 * them, so that curOffset always points at the next block header.
+		 */
+		nread = BufFileReadRaw(file, (char *) &hdr, sizeof(hdr));
+		if (nread == 0)
+		{
+			file->nbytes = 0;
+			return;
+		}
+		if (nread != sizeof(hdr) || hdr.rawlen <= 0 || hdr.rawlen > BLCKSZ ||
+			hdr.len <= 0 || hdr.len > hdr.rawlen)
+			elog(ERROR, "invalid block header in compressed temporary file");
+
+		data = (hdr.len == hdr.rawlen) ? file->buffer.data : compress_buffer;
+		nread = BufFileReadRaw(file, data, hdr.len);
+		if (nread != hdr.len)
+			ereport(ERROR,
+					(errcode_for_file_access(),
+					 errmsg("could not read from temporary file: read only %zu of %zu bytes",
+							nread, (size_t) hdr.len)));
+
+		if (hdr.len == hdr.rawlen)
+			rawlen = hdr.rawlen;
+		else if (file->compress == TEMP_FILE_COMPRESSION_PGLZ)
+			rawlen = pglz_decompress(data, hdr.len, file->buffer.data,
+									 hdr.rawlen, true);
+		else
+		{
+#ifdef USE_LZ4
+			rawlen = LZ4_decompress_safe(data, file->buffer.data,
+										 hdr.len, hdr.rawlen);
+#else
+			rawlen = -1;
+#endif
+		}
+		if (rawlen != hdr.rawlen)
+			elog(ERROR, "compressed data is corrupted in temporary file");
+
+		file->nbytes = rawlen;
+		pgBufferUsage.temp_blks_read++;
+		return;
+	}
+
 	/*
 	 * Advance to next component file if necessary and possible.
 	 */
@@ -483,6 +606,69 @@ BufFileLoadBuffer(BufFile *file)
 		pgBufferUsage.temp_blks_read++;
 }
 
+/*
+ * BufFileReadRaw
+ *
+ * Read up to size bytes of raw file data starting at curOffset, crossing
+ * component-file boundaries as needed, and advance curOffset past them.
+ * Returns the number of bytes read, which is less than size only at end of
+ * file.  Used only for compressed files.
+ */
+static size_t
+BufFileReadRaw(BufFile *file, char *ptr, size_t size)
+{
+	size_t		nread = 0;
+
+	while (nread < size)
+	{
+		File		thisfile;
+		int			nthistime;
+		instr_time	io_start;
+		instr_time	io_time;
+
+		if (file->curOffset >= MAX_PHYSICAL_FILESIZE)
+		{
+			if (file->curFile + 1 >= file->numFiles)
+				break;
+			file->curFile++;
+			file->curOffset = 0;
+		}
+
+		thisfile = file->files[file->curFile];
+
+		if (track_io_timing)
+			INSTR_TIME_SET_CURRENT(io_start);
+		else
+			INSTR_TIME_SET_ZERO(io_start);
+
+		nthistime = FileRead(thisfile,
+							 ptr + nread,
+							 Min(size - nread,
+								 MAX_PHYSICAL_FILESIZE - file->curOffset),
+							 file->curOffset,
+							 WAIT_EVENT_BUFFILE_READ);
+		if (nthistime < 0)
+			ereport(ERROR,
+					(errcode_for_file_access(),
+					 errmsg("could not read file \"%s\": %m",
+							FilePathName(thisfile))));
+
+		if (track_io_timing)
+		{
+			INSTR_TIME_SET_CURRENT(io_time);
+			INSTR_TIME_ACCUM_DIFF(pgBufferUsage.temp_blk_read_time, io_time, io_start);
+		}
+
+		if (nthistime == 0)
+			break;
+
+		file->curOffset += nthistime;
+		nread += nthistime;
+	}
+
+	return nread;
+}
+
 /*
  * BufFileDumpBuffer
  *
@@ -492,16 +678,93 @@ BufFileLoadBuffer(BufFile *file)
  */
 static void
 BufFileDumpBuffer(BufFile *file)
+{
+	BufFileBlockHeader *hdr;
+	char	   *data;
+	int32		len = -1;
+
+	if (file->compress == TEMP_FILE_COMPRESSION_OFF)
+	{
+		BufFileWriteRaw(file, file->buffer.data, file->nbytes);
+		file->dirty = false;
+
+		/*
+		 * At this point, curOffset has been advanced to the end of the
+		 * buffer, ie, its original value + nbytes.  We need to make it point
+		 * to the logical file position, ie, original value + pos, in case
+		 * that is less (as could happen due to a small backwards seek in a
+		 * dirty buffer!)
+		 */
+		file->curOffset -= (file->nbytes - file->pos);
+		if (file->curOffset < 0)	/* handle possible segment crossing */
+		{
+			file->curFile--;
+			Assert(file->curFile >= 0);
+			file->curOffset += MAX_PHYSICAL_FILESIZE;
+		}
+
+		/*
+		 * Now we can set the buffer empty without changing the logical
+		 * position
+		 */
+		file->pos = 0;
+		file->nbytes = 0;
+		return;
+	}
+
+	/*
+	 * Compressed files are only ever written sequentially, so there are no
+	 * backwards seeks to worry about; the block goes at curOffset and the
+	 * logical position is simply after it.
+	 */
+	Assert(file->pos == file->nbytes);
+
+	hdr = (BufFileBlockHeader *) compress_buffer;
+	data = compress_buffer + sizeof(BufFileBlockHeader);
+
+	if (file->compress == TEMP_FILE_COMPRESSION_PGLZ)
+		len = pglz_compress(file->buffer.data, file->nbytes, data,
+							PGLZ_strategy_always);
+#ifdef USE_LZ4
+	else if (file->compress == TEMP_FILE_COMPRESSION_LZ4)
+		len = LZ4_compress_default(file->buffer.data, data, file->nbytes,
+								   file->nbytes - 1);
+#endif
+
+	/* Store the block uncompressed if compression failed or didn't help */
+	if (len <= 0 || len >= file->nbytes)
+	{
+		len = file->nbytes;
+		memcpy(data, file->buffer.data, len);
+	}
+
+	hdr->len = len;
+	hdr->rawlen = file->nbytes;
+	BufFileWriteRaw(file, compress_buffer, sizeof(BufFileBlockHeader) + len);
+
+	file->dirty = false;
+	file->pos = 0;
+	file->nbytes = 0;
+}
+
+/*
+ * BufFileWriteRaw
+ *
+ * Write size bytes of raw file data starting at curOffset, and advance
+ * curOffset past them.
+ */
+static void
+BufFileWriteRaw(BufFile *file, const char *ptr, int64 size)
 {
 	int64		wpos = 0;
 	int64		bytestowrite;
 	File		thisfile;
 
 	/*
-	 * Unlike BufFileLoadBuffer, we must dump the whole buffer even if it
+	 * Unlike BufFileLoadBuffer, we must write all the data even if it
 	 * crosses a component-file boundary; so we need a loop.
 	 */
-	while (wpos < file->nbytes)
+	while (wpos < size)
 	{
 		int64		availbytes;
 		instr_time	io_start;
@@ -521,7 +784,7 @@ BufFileDumpBuffer(BufFile *file)
 		/*
 		 * Determine how much we need to write into this file.
 		 */
-		bytestowrite = file->nbytes - wpos;
+		bytestowrite = size - wpos;
 		availbytes = MAX_PHYSICAL_FILESIZE - file->curOffset;
 
 		if (bytestowrite > availbytes)
@@ -535,7 +798,7 @@ BufFileDumpBuffer(BufFile *file)
 			INSTR_TIME_SET_ZERO(io_start);
 
 		bytestowrite = FileWrite(thisfile,
-								 file->buffer.data + wpos,
+								 ptr + wpos,
 								 bytestowrite,
 								 file->curOffset,
 								 WAIT_EVENT_BUFFILE_WRITE);
@@ -556,27 +819,6 @@ BufFileDumpBuffer(BufFile *file)
 
 		pgBufferUsage.temp_blks_written++;
 	}
-	file->dirty = false;
-
-	/*
-	 * At this point, curOffset has been advanced to the end of the buffer,
-	 * ie, its original value + nbytes.  We need to make it point to the
-	 * logical file position, ie, original value + pos, in case that is less
-	 * (as could happen due to a small backwards seek in a dirty buffer!)
-	 */
-	file->curOffset -= (file->nbytes - file->pos);
-	if (file->curOffset < 0)	/* handle possible segment crossing */
-	{
-		file->curFile--;
-		Assert(file->curFile >= 0);
-		file->curOffset += MAX_PHYSICAL_FILESIZE;
-	}
-
-	/*
-	 * Now we can set the buffer empty without changing the logical position
-	 */
-	file->pos = 0;
-	file->nbytes = 0;
 }
 
 /*
@@ -602,8 +844,13 @@ BufFileReadCommon(BufFile *file, void *ptr, size_t size, bool exact, bool eofOK)
 	{
 		if (file->pos >= file->nbytes)
 		{
-			/* Try to load more data into buffer. */
-			file->curOffset += file->pos;
+			/*
+			 * Try to load more data into buffer.  (For a compressed file,
+			 * curOffset was already advanced past the block when it was
+			 * loaded.)
+			 */
+			if (file->compress == TEMP_FILE_COMPRESSION_OFF)
+				file->curOffset += file->pos;
 			file->pos = 0;
 			file->nbytes = 0;
 			BufFileLoadBuffer(file);
@@ -742,6 +989,21 @@ BufFileSeek(BufFile *file, int fileno, pgoff_t offset, int whence)
 	int			newFile;
 	pgoff_t		newOffset;
 
+	if (file->compress != TEMP_FILE_COMPRESSION_OFF)
+	{
+		/* Only rewinding is supported; see BufFileCreateCompressTemp */
+		if (whence != SEEK_SET || fileno != 0 || offset != 0)
+			elog(ERROR, "cannot seek in compressed temporary file");
+
+		BufFileFlush(file);
+		file->readOnly = true;
+		file->curFile = 0;
+		file->curOffset = 0;
+		file->pos = 0;
+		file->nbytes = 0;
+		return 0;
+	}
+
 	switch (whence)
 	{
 		case SEEK_SET:
@@ -855,6 +1117,33 @@ BufFileSeekBlock(BufFile *file, int64 blknum)
 					   SEEK_SET);
 }
 
+/*
+ * BufFilePrefetchBlock --- initiate asynchronous read of a block
+ *
+ * Hints to the kernel that the n'th BLCKSZ-sized block of the file (in the
+ * same terms as BufFileSeekBlock) will be read soon, so that the I/O can
+ * overlap with other work.  This is useful for callers whose access pattern
+ * is predictable but not physically sequential, where the kernel's own
+ * read-ahead doesn't help.  Does nothing for compressed files, or if the
+ * block lies beyond the end of the file.
+ */
+void
+BufFilePrefetchBlock(BufFile *file, int64 blknum)
+{
+#ifdef USE_PREFETCH
+	int			fileno = (int) (blknum / BUFFILE_SEG_SIZE);
+
+	if (file->compress != TEMP_FILE_COMPRESSION_OFF ||
+		fileno >= file->numFiles)
+		return;
+
+	(void) FilePrefetch(file->files[fileno],
+						(pgoff_t) (blknum % BUFFILE_SEG_SIZE) * BLCKSZ,
+						BLCKSZ,
+						WAIT_EVENT_BUFFILE_READ);
+#endif							/* USE_PREFETCH */
+}
+
 /*
  * Returns the amount of data in the given BufFile, in bytes.
  *
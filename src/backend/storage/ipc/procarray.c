@@ -2039,15 +2039,16 @@ GetMaxSnapshotSubxidCount(void)
  * the fields that need to change and returns true. Otherwise it returns
  * false.
  *
- * This very likely can be evolved to not need ProcArrayLock held (at very
- * least in the case we already hold a snapshot), but that's for another day.
+ * The caller must hold ProcArrayLock, unless this backend already advertises
+ * an xmin; see GetSnapshotData().
  */
 static bool
 GetSnapshotDataReuse(Snapshot snapshot)
 {
 	uint64		curXactCompletionCount;
 
-	Assert(LWLockHeldByMe(ProcArrayLock));
+	Assert(LWLockHeldByMe(ProcArrayLock) ||
+		   TransactionIdIsValid(MyProc->xmin));
 
 	if (unlikely(snapshot->snapXactCompletionCount == 0))
 		return false;
@@ -2175,6 +2176,36 @@ GetSnapshotData(Snapshot snapshot)
 					 errmsg("out of memory")));
 	}
 
+#ifdef PG_HAVE_8BYTE_SINGLE_COPY_ATOMICITY
+
+	/*
+	 * If this backend already advertises an xmin, e.g. because it holds
+	 * another snapshot, reusing the previous snapshot doesn't require
+	 * entering anything into the PGPROC array.  Then we don't need
+	 * ProcArrayLock to check whether the snapshot is still valid, which
+	 * avoids contending with ProcArrayEndTransaction() when taking many
+	 * snapshots, as READ COMMITTED functions do.
+	 *
+	 * Without the lock, we might miss a transaction that is concurrently
+	 * incrementing xactCompletionCount in ProcArrayEndTransaction().  That's
+	 * harmless, as that transaction isn't reported as committed to anyone
+	 * before ProcArrayLock is released, so we're still allowed to regard it
+	 * as running, just as if we'd acquired the lock before it did.  But any
+	 * transaction that has released the lock before we got here must be
+	 * noticed, hence the barrier.
+	 *
+	 * If we don't advertise an xmin yet, the lock is required to set it
+	 * safely with respect to concurrent ComputeXidHorizons() calls.  The
+	 * 64-bit counter can only be read without the lock if it can't be torn.
+	 */
+	if (TransactionIdIsValid(MyProc->xmin))
+	{
+		pg_memory_barrier();
+		if (GetSnapshotDataReuse(snapshot))
+			return snapshot;
+	}
+#endif
+
 	/*
 	 * It is sufficient to get shared lock on ProcArrayLock, even if we are
 	 * going to set MyProc->xmin.
@@ -124,10 +124,15 @@
  * iteration of SIInsertDataEntries.  Noncritical but should be less than
  * CLEANUP_QUANTUM, because we only consider calling SICleanupQueue once
  * per iteration.
+ *
+ * A backend that falls more than MAXNUMMESSAGES behind has to reset all its
+ * caches, which is far more expensive than reading the messages it missed.
+ * So the buffer is sized to absorb bursts of DDL (for example on partitioned
+ * tables) without pushing backends that are merely slow into a reset.
  */
 
-#define MAXNUMMESSAGES 4096
-#define MSGNUMWRAPAROUND (MAXNUMMESSAGES * 262144)
+#define MAXNUMMESSAGES 16384
+#define MSGNUMWRAPAROUND (MAXNUMMESSAGES * 65536)
 #define CLEANUP_MIN (MAXNUMMESSAGES / 2)
 #define CLEANUP_QUANTUM (MAXNUMMESSAGES / 16)
 #define SIG_THRESHOLD (MAXNUMMESSAGES / 2)
@@ -14,9 +14,45 @@
 #include "postgres.h"
 
 #include "storage/checksum.h"
+
+/*
+ * On x86-64, the baseline instruction set lacks the 32-bit vector multiply
+ * the algorithm depends on, so we additionally compile the block checksum for
+ * AVX2 and use that when the CPU supports it.
+ */
+#if defined(USE_SSE2) && __has_attribute (target)
+#define USE_AVX2_CHECKSUM_WITH_RUNTIME_CHECK
+#include "port/pg_cpu.h"
+#endif
+
 /*
  * The actual code is in storage/checksum_impl.h.  This is done so that
  * external programs can incorporate the checksum code by #include'ing
  * that file from the exported Postgres headers.  (Compare our CRC code.)
+ * We supply pg_checksum_block() ourselves, to keep the run-time CPU
+ * feature check out of that file.
  */
+#define PG_CHECKSUM_CUSTOM_BLOCK
 #include "storage/checksum_impl.h"	/* IWYU pragma: keep */
+
+#ifdef USE_AVX2_CHECKSUM_WITH_RUNTIME_CHECK
+/*
+ * The same code, for the compiler to vectorize using 256-bit registers.
+ */
+pg_attribute_target("avx2")
+static uint32
+pg_checksum_block_avx2(const PGChecksummablePage *page)
+{
+	return pg_checksum_block_inline(page);
+}
+#endif
+
+static uint32
+pg_checksum_block(const PGChecksummablePage *page)
+{
+#ifdef USE_AVX2_CHECKSUM_WITH_RUNTIME_CHECK
+	if (x86_feature_available(PG_AVX2))
+		return pg_checksum_block_avx2(page);
+#endif
+	return pg_checksum_block_inline(page);
+}
@@ -253,6 +253,8 @@ pgstat_flush_backend_entry_wal(PgStat_EntryRef *entry_ref)
 	WALSTAT_ACC(wal_fpi, wal_usage_diff);
 	WALSTAT_ACC(wal_bytes, wal_usage_diff);
 	WALSTAT_ACC(wal_fpi_bytes, wal_usage_diff);
+	WALSTAT_ACC(wal_flush_requests, wal_usage_diff);
+	WALSTAT_ACC(wal_group_flushes, wal_usage_diff);
 #undef WALSTAT_ACC
 
 	/*
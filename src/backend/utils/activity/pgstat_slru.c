@@ -17,6 +17,7 @@
 
 #include "postgres.h"
 
+#include "storage/bufmgr.h"
 #include "utils/pgstat_internal.h"
 #include "utils/timestamp.h"
 
@@ -83,6 +84,31 @@ PGSTAT_COUNT_SLRU(flush)
 /* pgstat_count_slru_truncate */
 PGSTAT_COUNT_SLRU(truncate)
 
+/*
+ * Accumulate the time spent on an SLRU page read or write that started at
+ * io_start, as returned by pgstat_prepare_io_time().  Does nothing unless
+ * track_io_timing is enabled.
+ */
+#define PGSTAT_COUNT_SLRU_TIME(stat)							\
+void															\
+CppConcat(pgstat_count_slru_,stat)(int slru_idx, instr_time io_start) \
+{																\
+	instr_time	io_time;										\
+																\
+	if (!track_io_timing)										\
+		return;													\
+	INSTR_TIME_SET_CURRENT(io_time);							\
+	INSTR_TIME_SUBTRACT(io_time, io_start);						\
+	get_slru_entry(slru_idx)->blk_##stat +=						\
+		INSTR_TIME_GET_MICROSEC(io_time);						\
+}
+
+/* pgstat_count_slru_read_time */
+PGSTAT_COUNT_SLRU_TIME(read_time)
+
+/* pgstat_count_slru_write_time */
+PGSTAT_COUNT_SLRU_TIME(write_time)
+
 /*
  * Support function for the SQL-callable pgstat* functions. Returns
  * a pointer to the slru statistics struct.
@@ -165,6 +191,8 @@ pgstat_slru_flush_cb(bool nowait)
 		SLRU_ACC(blocks_exists);
 		SLRU_ACC(flush);
 		SLRU_ACC(truncate);
+		SLRU_ACC(blk_read_time);
+		SLRU_ACC(blk_write_time);
 #undef SLRU_ACC
 	}
 
@@ -123,6 +123,8 @@ pgstat_wal_flush_cb(bool nowait)
 	WALSTAT_ACC(wal_bytes, wal_usage_diff);
 	WALSTAT_ACC(wal_fpi_bytes, wal_usage_diff);
 	WALSTAT_ACC(wal_buffers_full, wal_usage_diff);
+	WALSTAT_ACC(wal_flush_requests, wal_usage_diff);
+	WALSTAT_ACC(wal_group_flushes, wal_usage_diff);
 #undef WALSTAT_ACC
 
 	LWLockRelease(&stats_shmem->lock);
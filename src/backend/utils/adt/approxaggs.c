@@ -0,0 +1,212 @@
+/*-------------------------------------------------------------------------
+ *
+ * approxaggs.c
+ *	  Approximate aggregate functions.
+ *
+ * approx_count_distinct() estimates the number of distinct non-null input
+ * values with a HyperLogLog counter (see lib/hyperloglog.c), using a fixed
+ * amount of memory per group no matter how many values are added.  Values
+ * are hashed with the default hash opclass function of their type, so they
+ * are considered distinct or equal the same way that a hashed DISTINCT
+ * would.  The transition state can be serialized and combined, so the
+ * aggregate supports partial and parallel aggregation.
+ *
+ * Portions Copyright (c) 1996-2026, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *
+ * IDENTIFICATION
+ *	  src/backend/utils/adt/approxaggs.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include <math.h>
+
+#include "common/hashfn.h"
+#include "fmgr.h"
+#include "lib/hyperloglog.h"
+#include "libpq/pqformat.h"
+#include "utils/builtins.h"
+#include "utils/typcache.h"
+#include "varatt.h"
+
+/*
+ * Register width used by approx_count_distinct().  2^14 one-byte registers
+ * give a standard error of about 0.8% (1.04 / sqrt(2^14)).
+ */
+#define APPROX_COUNT_DISTINCT_BWIDTH	14
+
+static hyperLogLogState *makeHyperLogLogState(MemoryContext aggcontext,
+											  uint8 bwidth);
+
+/*
+ * Allocate and initialize a HyperLogLog counter in the given context.
+ */
+static hyperLogLogState *
+makeHyperLogLogState(MemoryContext aggcontext, uint8 bwidth)
+{
+	hyperLogLogState *state;
+	MemoryContext oldcontext;
+
+	oldcontext = MemoryContextSwitchTo(aggcontext);
+	state = palloc_object(hyperLogLogState);
+	initHyperLogLog(state, bwidth);
+	MemoryContextSwitchTo(oldcontext);
+
+	return state;
+}
+
+/*
+ * approx_count_distinct_transfn
+ *		Add a value to the HyperLogLog counter.
+ */
+Datum
+approx_count_distinct_transfn(PG_FUNCTION_ARGS)
+{
+	MemoryContext aggcontext;
+	hyperLogLogState *state;
+	TypeCacheEntry *typentry;
+	uint32		hash;
+
+	if (!AggCheckCallContext(fcinfo, &aggcontext))
+		elog(ERROR, "approx_count_distinct_transfn called in non-aggregate context");
+
+	if (PG_ARGISNULL(0))
+		state = makeHyperLogLogState(aggcontext, APPROX_COUNT_DISTINCT_BWIDTH);
+	else
+		state = (hyperLogLogState *) PG_GETARG_POINTER(0);
+
+	/* Nulls are not counted */
+	if (PG_ARGISNULL(1))
+		PG_RETURN_POINTER(state);
+
+	/* Look up the hash function only once per series of calls */
+	typentry = (TypeCacheEntry *) fcinfo->flinfo->fn_extra;
+	if (typentry == NULL)
+	{
+		Oid			argtype = get_fn_expr_argtype(fcinfo->flinfo, 1);
+
+		typentry = lookup_type_cache(argtype, TYPECACHE_HASH_PROC_FINFO);
+		if (!OidIsValid(typentry->hash_proc_finfo.fn_oid))
+			ereport(ERROR,
+					(errcode(ERRCODE_UNDEFINED_FUNCTION),
+					 errmsg("could not identify a hash function for type %s",
+							format_type_be(argtype))));
+		fcinfo->flinfo->fn_extra = typentry;
+	}
+
+	hash = DatumGetUInt32(FunctionCall1Coll(&typentry->hash_proc_finfo,
+											PG_GET_COLLATION(),
+											PG_GETARG_DATUM(1)));
+
+	/*
+	 * HyperLogLog relies on the bits of the hash being uniformly distributed,
+	 * which is not guaranteed for every type's hash function (some hash small
+	 * integers to themselves, for instance), so scramble it some more.
+	 */
+	addHyperLogLog(state, murmurhash32(hash));
+
+	PG_RETURN_POINTER(state);
+}
+
+/*
+ * approx_count_distinct_combine
+ *		Merge two HyperLogLog counters.
+ */
+Datum
+approx_count_distinct_combine(PG_FUNCTION_ARGS)
+{
+	MemoryContext aggcontext;
+	hyperLogLogState *state1;
+	hyperLogLogState *state2;
+
+	if (!AggCheckCallContext(fcinfo, &aggcontext))
+		elog(ERROR, "aggregate function called in non-aggregate context");
+
+	state1 = PG_ARGISNULL(0) ? NULL : (hyperLogLogState *) PG_GETARG_POINTER(0);
+	state2 = PG_ARGISNULL(1) ? NULL : (hyperLogLogState *) PG_GETARG_POINTER(1);
+
+	if (state2 == NULL)
+		PG_RETURN_POINTER(state1);
+
+	/* Copy state2 into the aggregate context if state1 doesn't exist yet */
+	if (state1 == NULL)
+		state1 = makeHyperLogLogState(aggcontext, state2->registerWidth);
+
+	mergeHyperLogLog(state1, state2);
+
+	PG_RETURN_POINTER(state1);
+}
+
+/*
+ * approx_count_distinct_serialize
+ *		Serialize a HyperLogLog counter into bytea.
+ */
+Datum
+approx_count_distinct_serialize(PG_FUNCTION_ARGS)
+{
+	hyperLogLogState *state;
+	StringInfoData buf;
+
+	/* Ensure we disallow calling when not in aggregate context */
+	if (!AggCheckCallContext(fcinfo, NULL))
+		elog(ERROR, "aggregate function called in non-aggregate context");
+
+	state = (hyperLogLogState *) PG_GETARG_POINTER(0);
+
+	pq_begintypsend(&buf);
+	pq_sendbyte(&buf, state->registerWidth);
+	pq_sendbytes(&buf, state->hashesArr, state->nRegisters);
+
+	PG_RETURN_BYTEA_P(pq_endtypsend(&buf));
+}
+
+/*
+ * approx_count_distinct_deserialize
+ *		Deserialize a HyperLogLog counter from bytea.
+ */
+Datum
+approx_count_distinct_deserialize(PG_FUNCTION_ARGS)
+{
+	bytea	   *sstate;
+	hyperLogLogState *state;
+	StringInfoData buf;
+	uint8		bwidth;
+
+	if (!AggCheckCallContext(fcinfo, NULL))
+		elog(ERROR, "aggregate function called in non-aggregate context");
+
+	sstate = PG_GETARG_BYTEA_PP(0);
+
+	initReadOnlyStringInfo(&buf, VARDATA_ANY(sstate),
+						   VARSIZE_ANY_EXHDR(sstate));
+
+	bwidth = pq_getmsgbyte(&buf);
+	state = makeHyperLogLogState(CurrentMemoryContext, bwidth);
+	pq_copymsgbytes(&buf, state->hashesArr, state->nRegisters);
+	pq_getmsgend(&buf);
+
+	PG_RETURN_POINTER(state);
+}
+
+/*
+ * approx_count_distinct_finalfn
+ *		Return the estimated number of distinct values.
+ */
+Datum
+approx_count_distinct_finalfn(PG_FUNCTION_ARGS)
+{
+	hyperLogLogState *state;
+
+	/* cannot be called directly because of internal-type argument */
+	Assert(AggCheckCallContext(fcinfo, NULL));
+
+	if (PG_ARGISNULL(0))
+		PG_RETURN_INT64(0);
+
+	state = (hyperLogLogState *) PG_GETARG_POINTER(0);
+
+	PG_RETURN_INT64((int64) rint(estimateHyperLogLog(state)));
+}
@@ -112,6 +112,7 @@ wchareq(const char *p1, int p1len, const char *p2, int p2len)
 #define CHAREQ(p1, p1len, p2, p2len) (*(p1) == *(p2))
 #define NextChar(p, plen) NextByte((p), (plen))
 #define CopyAdvChar(dst, src, srclen) (*(dst)++ = *(src)++, (srclen)--)
+#define MATCH_BYTE_SEARCH
 
 #define MatchText	SB_MatchText
 #define do_like_escape	SB_do_like_escape
@@ -129,6 +130,7 @@ wchareq(const char *p1, int p1len, const char *p2, int p2len)
 
 #define NextChar(p, plen) \
 	do { (p)++; (plen)--; } while ((plen) > 0 && (*(p) & 0xC0) == 0x80 )
+#define MATCH_BYTE_SEARCH
 #define MatchText	UTF8_MatchText
 
 #include "like_match.c"
@@ -15,6 +15,9 @@
  * MatchText - to name of function wanted
  * do_like_escape - name of function if wanted - needs CHAREQ and CopyAdvChar
  * MATCH_LOWER - define for case (4) to specify case folding for 1-byte chars
+ * MATCH_BYTE_SEARCH - define if a byte that can start a character never
+ *		occurs inside another character, so that % can search for the next
+ *		candidate position with memchr() (cases (1) and (2))
  *
  * Copyright (c) 1996-2026, PostgreSQL Global Development Group
  *
@@ -178,6 +181,24 @@ MatchText(const char *t, int tlen, const char *p, int plen, pg_locale_t locale)
 
 			while (tlen > 0)
 			{
+#ifdef MATCH_BYTE_SEARCH
+
+				/*
+				 * Skip directly to the next occurrence of the first pattern
+				 * byte.  memchr() is typically much faster than stepping
+				 * through the text ourselves, and any byte it finds is at a
+				 * character boundary.
+				 */
+				if (!locale || locale->deterministic)
+				{
+					const char *next = memchr(t, firstpat, tlen);
+
+					if (next == NULL)
+						break;
+					tlen -= next - t;
+					t = next;
+				}
+#endif
 				if (GETCHAR(*t) == firstpat || (locale && !locale->deterministic))
 				{
 					int			matched = MatchText(t, tlen, p, plen, locale);
@@ -505,5 +526,9 @@ do_like_escape(text *pat, text *esc)
 
 #ifdef MATCH_LOWER
 #undef MATCH_LOWER
+#endif
+
+#ifdef MATCH_BYTE_SEARCH
+#undef MATCH_BYTE_SEARCH
 
 #endif
@@ -1649,7 +1649,7 @@ static Datum
 pg_stat_wal_build_tuple(PgStat_WalCounters wal_counters,
 						TimestampTz stat_reset_timestamp)
 {
-#define PG_STAT_WAL_COLS	6
+#define PG_STAT_WAL_COLS	8
 	TupleDesc	tupdesc;
 	Datum		values[PG_STAT_WAL_COLS] = {0};
 	bool		nulls[PG_STAT_WAL_COLS] = {0};
@@ -1667,7 +1667,11 @@ pg_stat_wal_build_tuple(PgStat_WalCounters wal_counters,
 					   NUMERICOID, -1, 0);
 	TupleDescInitEntry(tupdesc, (AttrNumber) 5, "wal_buffers_full",
 					   INT8OID, -1, 0);
-	TupleDescInitEntry(tupdesc, (AttrNumber) 6, "stats_reset",
+	TupleDescInitEntry(tupdesc, (AttrNumber) 6, "wal_flush_requests",
+					   INT8OID, -1, 0);
+	TupleDescInitEntry(tupdesc, (AttrNumber) 7, "wal_group_flushes",
+					   INT8OID, -1, 0);
+	TupleDescInitEntry(tupdesc, (AttrNumber) 8, "stats_reset",
 					   TIMESTAMPTZOID, -1, 0);
 
 	BlessTupleDesc(tupdesc);
@@ -1690,11 +1694,13 @@ pg_stat_wal_build_tuple(PgStat_WalCounters wal_counters,
 									Int32GetDatum(-1));
 
 	values[4] = Int64GetDatum(wal_counters.wal_buffers_full);
+	values[5] = Int64GetDatum(wal_counters.wal_flush_requests);
+	values[6] = Int64GetDatum(wal_counters.wal_group_flushes);
 
 	if (stat_reset_timestamp != 0)
-		values[5] = TimestampTzGetDatum(stat_reset_timestamp);
+		values[7] = TimestampTzGetDatum(stat_reset_timestamp);
 	else
-		nulls[5] = true;
+		nulls[7] = true;
 
 	/* Returns the record as Datum */
 	PG_RETURN_DATUM(HeapTupleGetDatum(heap_form_tuple(tupdesc, values, nulls)));
@@ -1743,7 +1749,7 @@ pg_stat_get_wal(PG_FUNCTION_ARGS)
 Datum
 pg_stat_get_slru(PG_FUNCTION_ARGS)
 {
-#define PG_STAT_GET_SLRU_COLS	9
+#define PG_STAT_GET_SLRU_COLS	11
 	ReturnSetInfo *rsinfo = (ReturnSetInfo *) fcinfo->resultinfo;
 	int			i;
 	PgStat_SLRUStats *stats;
@@ -1776,7 +1782,10 @@ pg_stat_get_slru(PG_FUNCTION_ARGS)
 		values[5] = Int64GetDatum(stat.blocks_exists);
 		values[6] = Int64GetDatum(stat.flush);
 		values[7] = Int64GetDatum(stat.truncate);
-		values[8] = TimestampTzGetDatum(stat.stat_reset_timestamp);
+		/* convert counters from microsec to millisec for display */
+		values[8] = Float8GetDatum(((double) stat.blk_read_time) / 1000.0);
+		values[9] = Float8GetDatum(((double) stat.blk_write_time) / 1000.0);
+		values[10] = TimestampTzGetDatum(stat.stat_reset_timestamp);
 
 		tuplestore_putvalues(rsinfo->setResult, rsinfo->setDesc, values, nulls);
 	}
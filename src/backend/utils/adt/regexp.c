@@ -76,7 +76,7 @@ typedef struct regexp_matches_ctx
  * the array, dropping the entry at the end of the array if necessary to
  * make room.  (This might seem to be weighting the new entry too heavily,
  * but if we insert new entries further back, we'll be unable to adjust to
- * a sudden shift in the query mix where we are presented with MAX_CACHED_RES
+ * a sudden shift in the query mix where we are presented with regex_cache_size
  * never-before-seen items used circularly.  We ought to be able to handle
  * that case, so we have to insert at the front.)
  *
@@ -87,13 +87,11 @@ typedef struct regexp_matches_ctx
  * A reusable pattern that isn't used at least as often as non-reusable
  * patterns are seen will "fail to keep up" and will drop off the end of the
  * cache.  With move-to-front, a reusable pattern is guaranteed to stay in
- * the cache as long as it's used at least once in every MAX_CACHED_RES uses.
+ * the cache as long as it's used at least once in every regex_cache_size uses.
  */
 
-/* this is the maximum number of cached regular expressions */
-#ifndef MAX_CACHED_RES
-#define MAX_CACHED_RES	32
-#endif
+/* GUC variable: the maximum number of cached regular expressions */
+int			regex_cache_size = 32;
 
 /* A parent memory context for regular expressions. */
 static MemoryContext RegexpCacheMemoryContext;
@@ -110,7 +108,8 @@ typedef struct cached_re_str
 } cached_re_str;
 
 static int	num_res = 0;		/* # of cached re's */
-static cached_re_str re_array[MAX_CACHED_RES];	/* cached re's */
+static int	max_res = 0;		/* allocated length of re_array */
+static cached_re_str *re_array = NULL;	/* cached re's */
 
 
 /* Local functions */
@@ -183,6 +182,28 @@ RE_compile_and_cache(text *text_re, int cflags, Oid collation)
 								  "RegexpCacheMemoryContext",
 								  ALLOCSET_SMALL_SIZES);
 
+	/*
+	 * Size the array to match regex_cache_size, which may have changed since
+	 * the last time through.  If it was reduced, discard the excess entries
+	 * from the end of the list.
+	 */
+	if (unlikely(max_res != regex_cache_size))
+	{
+		while (num_res > regex_cache_size)
+		{
+			--num_res;
+			MemoryContextDelete(re_array[num_res].cre_context);
+		}
+
+		if (re_array == NULL)
+			re_array = MemoryContextAlloc(RegexpCacheMemoryContext,
+										  regex_cache_size * sizeof(cached_re_str));
+		else
+			re_array = repalloc(re_array,
+								regex_cache_size * sizeof(cached_re_str));
+		max_res = regex_cache_size;
+	}
+
 	/*
 	 * Couldn't find it, so try to compile the new RE.  To avoid leaking
 	 * resources on failure, we build into the re_temp local.
@@ -242,10 +263,10 @@ RE_compile_and_cache(text *text_re, int cflags, Oid collation)
 	 * Okay, we have a valid new item in re_temp; insert it into the storage
 	 * array.  Discard last entry if needed.
 	 */
-	if (num_res >= MAX_CACHED_RES)
+	if (num_res >= max_res)
 	{
 		--num_res;
-		Assert(num_res < MAX_CACHED_RES);
+		Assert(num_res < max_res);
 		/* Delete the memory context holding the regexp and pattern. */
 		MemoryContextDelete(re_array[num_res].cre_context);
 	}
@@ -83,6 +83,9 @@ static CatCInProgress *catcache_in_progress_stack = NULL;
 /* Cache management header --- pointer is NULL until created */
 static CatCacheHeader *CacheHdr = NULL;
 
+/* GUC parameter: limit on the number of entries in each cache, 0 if none */
+int			catalog_cache_max_entries = 0;
+
 static inline HeapTuple SearchCatCacheInternal(CatCache *cache,
 											   int nkeys,
 											   Datum v1, Datum v2,
@@ -109,6 +112,7 @@ static void CatCachePrintStats(int code, Datum arg);
 static void CatCacheRemoveCTup(CatCache *cache, CatCTup *ct);
 static void CatCacheRemoveCList(CatCache *cache, CatCList *cl);
 static void RehashCatCache(CatCache *cp);
+static void CatCacheEvictEntries(CatCache *cache);
 static void RehashCatCacheLists(CatCache *cp);
 static void CatalogCacheInitializeCache(CatCache *cache);
 static CatCTup *CatalogCacheCreateEntry(CatCache *cache, HeapTuple ntp,
@@ -466,6 +470,7 @@ CatCachePrintStats(int code, Datum arg)
 	uint64		cc_neg_hits = 0;
 	uint64		cc_newloads = 0;
 	uint64		cc_invals = 0;
+	uint64		cc_evictions = 0;
 	uint64		cc_nlists = 0;
 	uint64		cc_lsearches = 0;
 	uint64		cc_lhits = 0;
@@ -478,8 +483,8 @@ CatCachePrintStats(int code, Datum arg)
 			continue;			/* don't print unused caches */
 		elog(DEBUG2, "catcache %s/%u: %d tup, %" PRIu64 " srch, %" PRIu64 "+%"
 			 PRIu64 "=%" PRIu64 " hits, %" PRIu64 "+%" PRIu64 "=%"
-			 PRIu64 " loads, %" PRIu64 " invals, %d lists, %" PRIu64
-			 " lsrch, %" PRIu64 " lhits",
+			 PRIu64 " loads, %" PRIu64 " invals, %" PRIu64 " evicts, %d lists, %"
+			 PRIu64 " lsrch, %" PRIu64 " lhits",
 			 cache->cc_relname,
 			 cache->cc_indexoid,
 			 cache->cc_ntup,
@@ -491,6 +496,7 @@ CatCachePrintStats(int code, Datum arg)
 			 cache->cc_searches - cache->cc_hits - cache->cc_neg_hits - cache->cc_newloads,
 			 cache->cc_searches - cache->cc_hits - cache->cc_neg_hits,
 			 cache->cc_invals,
+			 cache->cc_evictions,
 			 cache->cc_nlist,
 			 cache->cc_lsearches,
 			 cache->cc_lhits);
@@ -499,14 +505,15 @@ CatCachePrintStats(int code, Datum arg)
 		cc_neg_hits += cache->cc_neg_hits;
 		cc_newloads += cache->cc_newloads;
 		cc_invals += cache->cc_invals;
+		cc_evictions += cache->cc_evictions;
 		cc_nlists += cache->cc_nlist;
 		cc_lsearches += cache->cc_lsearches;
 		cc_lhits += cache->cc_lhits;
 	}
 	elog(DEBUG2, "catcache totals: %d tup, %" PRIu64 " srch, %" PRIu64 "+%"
 		 PRIu64 "=%" PRIu64 " hits, %" PRIu64 "+%" PRIu64 "=%" PRIu64
-		 " loads, %" PRIu64 " invals, %" PRIu64 " lists, %" PRIu64
-		 " lsrch, %" PRIu64 " lhits",
+		 " loads, %" PRIu64 " invals, %" PRIu64 " evicts, %" PRIu64
+		 " lists, %" PRIu64 " lsrch, %" PRIu64 " lhits",
 		 CacheHdr->ch_ntup,
 		 cc_searches,
 		 cc_hits,
@@ -516,6 +523,7 @@ CatCachePrintStats(int code, Datum arg)
 		 cc_searches - cc_hits - cc_neg_hits - cc_newloads,
 		 cc_searches - cc_hits - cc_neg_hits,
 		 cc_invals,
+		 cc_evictions,
 		 cc_nlists,
 		 cc_lsearches,
 		 cc_lhits);
@@ -1030,6 +1038,56 @@ RehashCatCache(CatCache *cp)
 	cp->cc_bucket = newbucket;
 }
 
+/*
+ * Evict entries from a catcache that has reached catalog_cache_max_entries.
+ *
+ * This is a clock sweep over the hash buckets: an entry that has been used
+ * since the sweep last passed it gets a second chance, others are removed.
+ * Entries that are referenced, dead, or members of a CatCList are left
+ * alone; they go away through the usual paths.  To avoid doing this on every
+ * insertion, we free a tenth of the limit at a time, but give up after two
+ * full rounds in case most of the cache can't be evicted.
+ */
+static void
+CatCacheEvictEntries(CatCache *cache)
+{
+	int			target;
+	int			nswept = 0;
+
+	target = catalog_cache_max_entries - catalog_cache_max_entries / 10 - 1;
+
+	while (cache->cc_ntup > target && nswept < cache->cc_nbuckets * 2)
+	{
+		dlist_head *bucket;
+		dlist_mutable_iter iter;
+
+		cache->cc_evict_bucket %= cache->cc_nbuckets;
+		bucket = &cache->cc_bucket[cache->cc_evict_bucket];
+
+		dlist_foreach_modify(iter, bucket)
+		{
+			CatCTup    *ct = dlist_container(CatCTup, cache_elem, iter.cur);
+
+			if (ct->refcount > 0 || ct->dead || ct->c_list != NULL)
+				continue;
+
+			if (ct->recent)
+			{
+				ct->recent = false;
+				continue;
+			}
+
+			CatCacheRemoveCTup(cache, ct);
+#ifdef CATCACHE_STATS
+			cache->cc_evictions++;
+#endif
+		}
+
+		cache->cc_evict_bucket++;
+		nswept++;
+	}
+}
+
 /*
  * Enlarge a catcache's list storage, doubling the number of buckets.
  */
@@ -1473,6 +1531,7 @@ SearchCatCacheInternal(CatCache *cache,
 		 * near the front of the hashbucket's list.)
 		 */
 		dlist_move_head(bucket, &ct->cache_elem);
+		ct->recent = true;
 
 		/*
 		 * If it's a positive entry, bump its refcount and return it. If it's
@@ -2278,8 +2337,17 @@ CatalogCacheCreateEntry(CatCache *cache, HeapTuple ntp, Datum *arguments,
 	ct->refcount = 0;			/* for the moment */
 	ct->dead = false;
 	ct->negative = (ntp == NULL);
+	ct->recent = true;
 	ct->hash_value = hashValue;
 
+	/*
+	 * Make room first if the cache is at its size limit.  The new entry isn't
+	 * in the hash table yet, so it's safe from eviction.
+	 */
+	if (catalog_cache_max_entries > 0 &&
+		cache->cc_ntup >= catalog_cache_max_entries)
+		CatCacheEvictEntries(cache);
+
 	dlist_push_head(&cache->cc_bucket[hashIndex], &ct->cache_elem);
 
 	cache->cc_ntup++;
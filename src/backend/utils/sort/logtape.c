@@ -330,6 +330,17 @@ ltsReadFillBuffer(LogicalTape *lt)
 		/* Advance to next block, if we have buffer space left */
 	} while (lt->buffer_size - lt->nbytes > BLCKSZ);
 
+	/*
+	 * The blocks of a tape are generally not physically consecutive, so the
+	 * kernel's read-ahead won't anticipate the next one.  We know which block
+	 * comes next, though, so ask for it to be read in while the caller
+	 * consumes the buffer we just filled (and, during a merge, the buffers of
+	 * the other input tapes).
+	 */
+	if (lt->nextBlockNumber != -1L)
+		BufFilePrefetchBlock(lt->tapeSet->pfile,
+							 lt->nextBlockNumber + lt->offsetBlockNumber);
+
 	return (lt->nbytes > 0);
 }
 
@@ -104,6 +104,7 @@
 #include "commands/tablespace.h"
 #include "miscadmin.h"
 #include "pg_trace.h"
+#include "port/pg_bitutils.h"
 #include "storage/shmem.h"
 #include "utils/guc.h"
 #include "utils/memutils.h"
@@ -216,6 +217,15 @@ struct Tuplesortstate
 	int			memtupsize;		/* allocated length of memtuples array */
 	bool		growmemtuples;	/* memtuples' growth still underway? */
 
+	/*
+	 * While memtuples is a heap, heapMinChild caches the index of the smaller
+	 * of the top node's children, or -1 if unknown.  Replacing the top node
+	 * with a tuple that stays there doesn't change the children, so when the
+	 * same input tape keeps winning during a merge we needn't compare them
+	 * again.  Any other change to the heap must reset this.
+	 */
+	int			heapMinChild;
+
 	/*
 	 * Memory for tuples is sometimes allocated using a simple slab allocator,
 	 * rather than with palloc().  Currently, we switch to slab allocation
@@ -687,6 +697,7 @@ tuplesort_begin_batch(Tuplesortstate *state)
 	state->tapeset = NULL;
 
 	state->memtupcount = 0;
+	state->heapMinChild = -1;
 
 	state->growmemtuples = true;
 	state->slabAllocatorUsed = false;
@@ -784,6 +795,44 @@ tuplesort_used_bound(Tuplesortstate *state)
 	return state->boundUsed;
 }
 
+/*
+ * tuplesort_in_bounded_heap
+ *
+ * Return true if a bounded sort is currently collecting input in its heap,
+ * so that tuplesort_bounded_discard may be used.
+ */
+bool
+tuplesort_in_bounded_heap(Tuplesortstate *state)
+{
+	return state->status == TSS_BOUNDED;
+}
+
+/*
+ * tuplesort_bounded_discard
+ *
+ * While a bounded sort is collecting input in its heap, check whether a
+ * tuple whose first-column key value is datum1/isnull1 would be discarded on
+ * arrival because that key alone sorts it after every tuple already kept.
+ * This lets callers skip copying such tuples into sort memory.  A false
+ * result only means the tuple has to be added normally.
+ */
+bool
+tuplesort_bounded_discard(Tuplesortstate *state, Datum datum1, bool isnull1)
+{
+	Assert(state->status == TSS_BOUNDED);
+
+	/*
+	 * The sort direction is currently reversed, so a new tuple is discarded
+	 * when it compares below the top of the heap; see
+	 * tuplesort_puttuple_common.  Bounded sorts don't use abbreviated keys,
+	 * so datum1 of the heap's top is comparable with the caller's value.
+	 */
+	return ApplySortComparator(datum1, isnull1,
+							   state->memtuples[0].datum1,
+							   state->memtuples[0].isnull1,
+							   state->base.sortKeys) < 0;
+}
+
 /*
  * tuplesort_free
  *
@@ -2928,10 +2977,47 @@ radix_sort_tuple(SortTuple *data, size_t n, Tuplesortstate *state)
 			return;
 		else
 		{
-			radix_sort_recursive(not_null_start,
-								 not_null_count,
-								 0,
-								 state);
+			SortSupport ssup = &state->base.sortKeys[0];
+			Datum		first = normalize_datum(not_null_start->datum1, ssup);
+			Datum		diff = 0;
+
+			/*
+			 * Find the leading bytes that are the same in every key, which
+			 * is common for int4 keys or for values from a narrow range, and
+			 * skip them rather than spending a counting pass on each one
+			 * that puts every tuple into the same partition.
+			 */
+			for (SortTuple *st = not_null_start + 1;
+				 st < not_null_start + not_null_count;
+				 st++)
+			{
+				diff |= normalize_datum(st->datum1, ssup) ^ first;
+
+				CHECK_FOR_INTERRUPTS();
+			}
+
+			if (diff == 0)
+			{
+				/* all the datums are equal, only the tiebreak is left */
+				if (state->base.onlyKey == NULL)
+					qsort_tuple(not_null_start,
+								not_null_count,
+								state->base.comparetup_tiebreak,
+								state);
+			}
+			else
+			{
+				int			level;
+
+				level = (sizeof(Datum) * BITS_PER_BYTE - 1 -
+						 pg_leftmost_one_pos64(DatumGetUInt64(diff))) /
+					BITS_PER_BYTE;
+
+				radix_sort_recursive(not_null_start,
+									 not_null_count,
+									 level,
+									 state);
+			}
 		}
 	}
 }
@@ -3018,6 +3104,8 @@ tuplesort_heap_insert(Tuplesortstate *state, SortTuple *tuple)
 
 	CHECK_FOR_INTERRUPTS();
 
+	state->heapMinChild = -1;
+
 	/*
 	 * Sift-up the new entry, per Knuth 5.2.3 exercise 16. Note that Knuth is
 	 * using 1-based array indexes, not 0-based.
@@ -3048,6 +3136,8 @@ tuplesort_heap_delete_top(Tuplesortstate *state)
 	SortTuple  *memtuples = state->memtuples;
 	SortTuple  *tuple;
 
+	state->heapMinChild = -1;
+
 	if (--state->memtupcount <= 0)
 		return;
 
@@ -3090,13 +3180,22 @@ tuplesort_heap_replace_top(Tuplesortstate *state, SortTuple *tuple)
 
 		if (j >= n)
 			break;
-		if (j + 1 < n &&
-			COMPARETUP(state, &memtuples[j], &memtuples[j + 1]) > 0)
-			j++;
+		if (i == 0 && state->heapMinChild >= 0)
+			j = state->heapMinChild;
+		else
+		{
+			if (j + 1 < n &&
+				COMPARETUP(state, &memtuples[j], &memtuples[j + 1]) > 0)
+				j++;
+			if (i == 0)
+				state->heapMinChild = j;
+		}
 		if (COMPARETUP(state, tuple, &memtuples[j]) <= 0)
 			break;
 		memtuples[i] = memtuples[j];
 		i = j;
+		/* the top node's children are changing, forget about them */
+		state->heapMinChild = -1;
 	}
 	memtuples[i] = *tuple;
 }
@@ -3112,6 +3211,8 @@ reversedirection(Tuplesortstate *state)
 	SortSupport sortKey = state->base.sortKeys;
 	int			nkey;
 
+	state->heapMinChild = -1;
+
 	for (nkey = 0; nkey < state->base.nKeys; nkey++, sortKey++)
 	{
 		sortKey->ssup_reverse = !sortKey->ssup_reverse;
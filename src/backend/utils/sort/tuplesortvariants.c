@@ -759,6 +759,24 @@ tuplesort_puttupleslot(Tuplesortstate *state, TupleTableSlot *slot)
 	HeapTupleData htup;
 	Size		tuplen;
 
+	/*
+	 * Once a bounded sort has filled its heap, most input tuples can be
+	 * rejected by looking at their first key.  Check that before copying the
+	 * tuple, so that rejected tuples don't cost a copy.
+	 */
+	if (tuplesort_in_bounded_heap(state))
+	{
+		Datum		datum1;
+		bool		isnull1;
+
+		datum1 = slot_getattr(slot, base->sortKeys[0].ssup_attno, &isnull1);
+		if (tuplesort_bounded_discard(state, datum1, isnull1))
+		{
+			MemoryContextSwitchTo(oldcontext);
+			return;
+		}
+	}
+
 	/* copy the tuple into sort storage */
 	tuple = ExecCopySlotMinimalTuple(slot);
 	stup.tuple = tuple;
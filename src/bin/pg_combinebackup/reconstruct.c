@@ -690,17 +690,36 @@ write_reconstructed_file(char *input_filename,
 #if defined(HAVE_COPY_FILE_RANGE)
 			/* copy_file_range modifies the offset, so use a local copy */
 			off_t		off = offsetmap[i];
+			unsigned	nblocks = 1;
+			size_t		length;
 			size_t		nwritten = 0;
 
+			/*
+			 * Extend the range over the following blocks as long as they come
+			 * from consecutive offsets in the same source file, so that a
+			 * stretch of unchanged blocks is copied (or cloned, on file
+			 * systems that support it) by a single system call.
+			 */
+			while (i + nblocks < block_length &&
+				   sourcemap[i + nblocks] == s &&
+				   offsetmap[i + nblocks] == off + (off_t) nblocks * BLCKSZ)
+			{
+				s->num_blocks_read++;
+				nblocks++;
+			}
+			length = (size_t) nblocks * BLCKSZ;
+			s->highest_offset_read = Max(s->highest_offset_read,
+										 off + (off_t) length);
+
 			/*
 			 * Retry until we've written all the bytes (the offset is updated
 			 * by copy_file_range, and so is the wfd file offset).
 			 */
 			do
 			{
-				int			wb;
+				ssize_t		wb;
 
-				wb = copy_file_range(s->fd, &off, wfd, NULL, BLCKSZ - nwritten, 0);
+				wb = copy_file_range(s->fd, &off, wfd, NULL, length - nwritten, 0);
 
 				if (wb < 0)
 					pg_fatal("error while copying file range from \"%s\" to \"%s\": %m",
@@ -708,20 +727,26 @@ write_reconstructed_file(char *input_filename,
 
 				nwritten += wb;
 
-			} while (BLCKSZ > nwritten);
+			} while (length > nwritten);
 
 			/*
-			 * When checksum calculation not needed, we're done, otherwise
-			 * read the block and pass it to the checksum calculation.
+			 * When checksum calculation is needed, read back the blocks and
+			 * pass them to the checksum calculation.
 			 */
-			if (checksum_ctx->type == CHECKSUM_TYPE_NONE)
-				continue;
+			if (checksum_ctx->type != CHECKSUM_TYPE_NONE)
+			{
+				for (unsigned j = 0; j < nblocks; j++)
+				{
+					read_block(s, offsetmap[i] + (off_t) j * BLCKSZ, buffer);
 
-			read_block(s, offsetmap[i], buffer);
+					if (pg_checksum_update(checksum_ctx, buffer, BLCKSZ) < 0)
+						pg_fatal("could not update checksum of file \"%s\"",
+								 output_filename);
+				}
+			}
 
-			if (pg_checksum_update(checksum_ctx, buffer, BLCKSZ) < 0)
-				pg_fatal("could not update checksum of file \"%s\"",
-						 output_filename);
+			/* Skip over the blocks we copied along with this one. */
+			i += nblocks - 1;
 #else
 			pg_fatal("copy_file_range not supported on this platform");
 #endif
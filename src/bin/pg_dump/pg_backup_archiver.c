@@ -78,6 +78,7 @@ static bool _tocEntryIsACL(TocEntry *te);
 static void _disableTriggersIfNecessary(ArchiveHandle *AH, TocEntry *te);
 static void _enableTriggersIfNecessary(ArchiveHandle *AH, TocEntry *te);
 static bool is_load_via_partition_root(TocEntry *te);
+static bool can_copy_freeze(ArchiveHandle *AH, TocEntry *te);
 static void buildTocEntryArrays(ArchiveHandle *AH);
 static void _moveBefore(TocEntry *pos, TocEntry *te);
 static int	_discoverArchiveFormat(ArchiveHandle *AH);
@@ -1028,6 +1029,11 @@ restore_toc_entry(ArchiveHandle *AH, TocEntry *te, bool is_parallel)
 					 * boundaries, risking deadlock and/or loss of previously
 					 * loaded data.  (We assume that all partitions of a
 					 * partitioned table will be treated the same way.)
+					 *
+					 * Since the table is truncated in the same transaction,
+					 * we can also load it with COPY FREEZE, which saves the
+					 * VACUUM that would otherwise have to set hint bits and
+					 * freeze every restored tuple later.
 					 */
 					use_truncate = is_parallel && te->created &&
 						!is_load_via_partition_root(te);
@@ -1053,7 +1059,12 @@ restore_toc_entry(ArchiveHandle *AH, TocEntry *te, bool is_parallel)
 					 */
 					if (te->copyStmt && strlen(te->copyStmt) > 0)
 					{
-						ahprintf(AH, "%s", te->copyStmt);
+						if (use_truncate && can_copy_freeze(AH, te))
+							ahprintf(AH, "%.*s WITH (FREEZE);\n",
+									 (int) (strlen(te->copyStmt) - 2),
+									 te->copyStmt);
+						else
+							ahprintf(AH, "%s", te->copyStmt);
 						AH->outputKind = OUTPUT_COPYDATA;
 					}
 					else
@@ -1229,6 +1240,37 @@ is_load_via_partition_root(TocEntry *te)
 	return false;
 }
 
+/*
+ * Detect whether the COPY of a TABLE DATA TOC item, which is about to be
+ * loaded into a table truncated in the current transaction, can be issued
+ * with the FREEZE option.
+ *
+ * The server rejects COPY FREEZE into foreign tables, which we recognize by
+ * the description of the table's TOC entry, that TABLE DATA items depend on.
+ * We also insist on the COPY statement having the exact form pg_dump writes,
+ * so that we can safely append the option to it.
+ */
+static bool
+can_copy_freeze(ArchiveHandle *AH, TocEntry *te)
+{
+	TocEntry   *tabte;
+	size_t		len = strlen(te->copyStmt);
+
+	if (AH->public.remoteVersion < 90300)
+		return false;
+
+	if (len < 13 || strcmp(te->copyStmt + len - 13, " FROM stdin;\n") != 0)
+		return false;
+
+	if (te->nDeps < 1)
+		return false;
+	tabte = getTocEntryByDumpId(AH, te->dependencies[0]);
+	if (tabte == NULL || strcmp(tabte->desc, "TABLE") != 0)
+		return false;
+
+	return true;
+}
+
 /*
  * This is a routine that is part of the dumper interface, hence the 'Archive*' parameter.
  */
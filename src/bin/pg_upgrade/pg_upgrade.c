@@ -596,6 +596,8 @@ static void
 create_new_objects(void)
 {
 	int			dbnum;
+	int			ndbs_restore;
+	int			restore_jobs;
 	PGconn	   *conn_new_template1;
 
 	prep_status_progress("Restoring database schemas in the new cluster");
@@ -655,6 +657,23 @@ create_new_objects(void)
 		break;					/* done once we've processed template1 */
 	}
 
+	/*
+	 * If there are fewer databases to restore than jobs, let each pg_restore
+	 * use the leftover jobs to restore its database's post-data objects
+	 * (indexes, constraints, and so on) in parallel.  That matters for
+	 * clusters dominated by a single database with many relations.  The total
+	 * number of restore connections still doesn't exceed the number of jobs.
+	 */
+	ndbs_restore = 0;
+	for (dbnum = 0; dbnum < old_cluster.dbarr.ndbs; dbnum++)
+	{
+		if (strcmp(old_cluster.dbarr.dbs[dbnum].db_name, "template1") != 0)
+			ndbs_restore++;
+	}
+	restore_jobs = 1;
+	if (user_opts.jobs > 1 && ndbs_restore > 0)
+		restore_jobs = Max(user_opts.jobs / ndbs_restore, 1);
+
 	for (dbnum = 0; dbnum < old_cluster.dbarr.ndbs; dbnum++)
 	{
 		char		sql_file_name[MAXPGPATH],
@@ -697,12 +716,13 @@ create_new_objects(void)
 		parallel_exec_prog(log_file_name,
 						   NULL,
 						   "\"%s/pg_restore\" %s %s --exit-on-error --verbose "
-						   "--transaction-size=%d "
+						   "--transaction-size=%d --jobs=%d "
 						   "--dbname template1 \"%s/%s\"",
 						   new_cluster.bindir,
 						   cluster_conn_opts(&new_cluster),
 						   create_opts,
 						   txn_size,
+						   restore_jobs,
 						   log_opts.dumpdir,
 						   sql_file_name);
 	}
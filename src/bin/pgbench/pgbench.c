@@ -293,6 +293,8 @@ static uint32 max_tries = 1;
 static bool failures_detailed = false;	/* whether to group failures in
 										 * reports or logs by basic types */
 
+static bool latency_percentiles = false;	/* report latency percentiles */
+
 static const char *pghost = NULL;
 static const char *pgport = NULL;
 static const char *username = NULL;
@@ -364,6 +366,20 @@ typedef struct SimpleStats
 	double		sum2;			/* sum of squared values */
 } SimpleStats;
 
+/*
+ * Latency histogram used to report percentiles.  Values are in microseconds;
+ * values below LATENCY_HIST_SUB get a bucket each, and every larger power of
+ * two range is split into LATENCY_HIST_SUB equal buckets, which bounds the
+ * relative error of a reported percentile to about 1/LATENCY_HIST_SUB.
+ * Values of 2^(LATENCY_HIST_MAX_BIT + 1) microseconds or more (about 50 days)
+ * all land in the last bucket.
+ */
+#define LATENCY_HIST_SUB_BITS	4
+#define LATENCY_HIST_SUB		(1 << LATENCY_HIST_SUB_BITS)
+#define LATENCY_HIST_MAX_BIT	41
+#define LATENCY_HIST_BUCKETS \
+	((LATENCY_HIST_MAX_BIT - LATENCY_HIST_SUB_BITS + 2) * LATENCY_HIST_SUB)
+
 /*
  * The instr_time type is expensive when dealing with time arithmetic.  Define
  * a type to hold microseconds instead.  Type int64 is good enough for about
@@ -448,6 +464,8 @@ typedef struct StatsData
 									 * specified */
 	SimpleStats latency;
 	SimpleStats lag;
+	int64	   *latency_hist;	/* latency histogram with LATENCY_HIST_BUCKETS
+								 * entries, or NULL if not collected */
 } StatsData;
 
 /*
@@ -960,6 +978,7 @@ usage(void)
 		   "  --continue-on-error      continue running after an SQL error\n"
 		   "  --exit-on-abort          exit when any client is aborted\n"
 		   "  --failures-detailed      report the failures grouped by basic types\n"
+		   "  --latency-percentiles    report latency percentiles and maximum\n"
 		   "  --log-prefix=PREFIX      prefix for transaction time log file\n"
 		   "                           (default: \"pgbench_log\")\n"
 		   "  --max-tries=NUM          max number of tries to run transaction (default: 1)\n"
@@ -1434,6 +1453,67 @@ initStats(StatsData *sd, pg_time_usec_t start)
 	sd->other_sql_failures = 0;
 	initSimpleStats(&sd->latency);
 	initSimpleStats(&sd->lag);
+	sd->latency_hist = NULL;
+}
+
+/*
+ * Start collecting a latency histogram in the given StatsData struct.
+ */
+static void
+initLatencyHist(StatsData *sd)
+{
+	sd->latency_hist = pg_malloc0_array(int64, LATENCY_HIST_BUCKETS);
+}
+
+/*
+ * Return the histogram bucket for a latency in microseconds.
+ */
+static int
+latencyHistBucket(double latency)
+{
+	uint64		val = latency > 0 ? (uint64) latency : 0;
+	int			msb;
+
+	if (val < LATENCY_HIST_SUB)
+		return (int) val;
+
+	msb = pg_leftmost_one_pos64(val);
+	if (msb > LATENCY_HIST_MAX_BIT)
+		return LATENCY_HIST_BUCKETS - 1;
+
+	/* the top LATENCY_HIST_SUB_BITS + 1 bits select the bucket */
+	return (msb - LATENCY_HIST_SUB_BITS + 1) * LATENCY_HIST_SUB +
+		(int) (val >> (msb - LATENCY_HIST_SUB_BITS)) - LATENCY_HIST_SUB;
+}
+
+/*
+ * Return the largest latency in microseconds that maps to the given bucket.
+ */
+static double
+latencyHistBucketUpper(int bucket)
+{
+	int			msb;
+	uint64		top;
+
+	if (bucket < LATENCY_HIST_SUB)
+		return (double) bucket;
+
+	msb = bucket / LATENCY_HIST_SUB + LATENCY_HIST_SUB_BITS - 1;
+	top = bucket % LATENCY_HIST_SUB + LATENCY_HIST_SUB;
+	return (double) (((top + 1) << (msb - LATENCY_HIST_SUB_BITS)) - 1);
+}
+
+/*
+ * Merge the latency histogram of ss into acc, if both have one.
+ */
+static void
+mergeLatencyHist(StatsData *acc, StatsData *ss)
+{
+	if (acc->latency_hist == NULL || ss->latency_hist == NULL)
+		return;
+
+	for (int i = 0; i < LATENCY_HIST_BUCKETS; i++)
+		acc->latency_hist[i] += ss->latency_hist[i];
 }
 
 /*
@@ -1468,6 +1548,8 @@ accumStats(StatsData *stats, bool skipped, double lat, double lag,
 			stats->cnt++;
 
 			addToSimpleStats(&stats->latency, lat);
+			if (stats->latency_hist)
+				stats->latency_hist[latencyHistBucket(lat)]++;
 
 			/* and possibly the same for schedule lag */
 			if (throttle_delay)
@@ -4757,7 +4839,7 @@ processXactStats(TState *thread, CState *st, pg_time_usec_t *now,
 	double		latency = 0.0,
 				lag = 0.0;
 	bool		detailed = progress || throttle_delay || latency_limit ||
-		use_log || per_script_stats;
+		use_log || per_script_stats || latency_percentiles;
 
 	if (detailed && !skipped && st->estatus == ESTATUS_NO_ERROR)
 	{
@@ -6417,6 +6499,36 @@ printSimpleStats(const char *prefix, SimpleStats *ss)
 	}
 }
 
+/*
+ * Print latency percentiles and the maximum latency, if a histogram was
+ * collected.  The reported percentiles are the upper bounds of the buckets
+ * they fall into, capped at the maximum latency actually seen.
+ */
+static void
+printLatencyPercentiles(const char *prefix, StatsData *sd)
+{
+	static const double percentiles[] = {50.0, 90.0, 99.0, 99.9};
+	int64		cumulative = 0;
+	int			bucket = 0;
+
+	if (sd->latency_hist == NULL || sd->latency.count == 0)
+		return;
+
+	for (int i = 0; i < lengthof(percentiles); i++)
+	{
+		int64		rank = (int64) ceil(percentiles[i] / 100.0 * sd->latency.count);
+
+		rank = Max(rank, 1);
+		while (bucket < LATENCY_HIST_BUCKETS - 1 &&
+			   cumulative + sd->latency_hist[bucket] < rank)
+			cumulative += sd->latency_hist[bucket++];
+
+		printf("%s %gth percentile = %.3f ms\n", prefix, percentiles[i],
+			   0.001 * Min(latencyHistBucketUpper(bucket), sd->latency.max));
+	}
+	printf("%s max = %.3f ms\n", prefix, 0.001 * sd->latency.max);
+}
+
 /* print version banner */
 static void
 printVersion(PGconn *con)
@@ -6531,8 +6643,11 @@ printResults(StatsData *total,
 			   latency_limit / 1000.0, latency_late, total->cnt,
 			   (total->cnt > 0) ? 100.0 * latency_late / total->cnt : 0.0);
 
-	if (throttle_delay || progress || latency_limit)
+	if (throttle_delay || progress || latency_limit || latency_percentiles)
+	{
 		printSimpleStats("latency", &total->latency);
+		printLatencyPercentiles("latency", total);
+	}
 	else
 	{
 		/* no measurement, show average latency computed from run time */
@@ -6641,6 +6756,7 @@ printResults(StatsData *total,
 
 				}
 				printSimpleStats(" - latency", &sstats->latency);
+				printLatencyPercentiles(" - latency", sstats);
 			}
 
 			/*
@@ -6779,6 +6895,7 @@ main(int argc, char **argv)
 		{"exit-on-abort", no_argument, NULL, 16},
 		{"debug", no_argument, NULL, 17},
 		{"continue-on-error", no_argument, NULL, 18},
+		{"latency-percentiles", no_argument, NULL, 19},
 		{NULL, 0, NULL, 0}
 	};
 
@@ -7136,6 +7253,10 @@ main(int argc, char **argv)
 				benchmarking_option_set = true;
 				continue_on_error = true;
 				break;
+			case 19:			/* latency-percentiles */
+				benchmarking_option_set = true;
+				latency_percentiles = true;
+				break;
 			default:
 				/* getopt_long already emitted a complaint */
 				pg_log_error_hint("Try \"%s --help\" for more information.", progname);
@@ -7162,6 +7283,9 @@ main(int argc, char **argv)
 
 		/* cannot overflow: weight is 32b, total_weight 64b */
 		total_weight += sql_script[i].weight;
+
+		if (latency_percentiles)
+			initLatencyHist(&sql_script[i].stats);
 	}
 
 	if (total_weight == 0 && !is_init_mode)
@@ -7429,6 +7553,8 @@ main(int argc, char **argv)
 		thread->logfile = NULL; /* filled in later */
 		thread->latency_late = 0;
 		initStats(&thread->stats, 0);
+		if (latency_percentiles)
+			initLatencyHist(&thread->stats);
 
 		nclients_dealt += thread->nstate;
 	}
@@ -7469,6 +7595,8 @@ main(int argc, char **argv)
 
 	/* wait for other threads and accumulate results */
 	initStats(&stats, 0);
+	if (latency_percentiles)
+		initLatencyHist(&stats);
 	conn_total_duration = 0;
 
 	for (i = 0; i < nthreads; i++)
@@ -7485,6 +7613,7 @@ main(int argc, char **argv)
 		/* aggregate thread level stats */
 		mergeSimpleStats(&stats.latency, &thread->stats.latency);
 		mergeSimpleStats(&stats.lag, &thread->stats.lag);
+		mergeLatencyHist(&stats, &thread->stats);
 		stats.cnt += thread->stats.cnt;
 		stats.skipped += thread->stats.skipped;
 		stats.retries += thread->stats.retries;
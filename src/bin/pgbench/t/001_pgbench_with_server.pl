@@ -208,6 +208,20 @@ $node->pgbench(
 	],
 	'pgbench select only');
 
+$node->pgbench(
+	"-t 100 -c 2 -b se -b si -n --latency-percentiles",
+	0,
+	[
+		qr{processed: 200/200},
+		qr{latency average = \d+\.\d{3} ms},
+		qr{latency 50th percentile = \d+\.\d{3} ms},
+		qr{latency 99\.9th percentile = \d+\.\d{3} ms},
+		qr{latency max = \d+\.\d{3} ms},
+		qr{ - latency 99th percentile = \d+\.\d{3} ms}
+	],
+	[qr{^$}],
+	'pgbench latency percentiles');
+
 # check if threads are supported
 my $nthreads = 2;
 
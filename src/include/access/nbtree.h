@@ -1089,6 +1089,19 @@ typedef struct BTScanOpaqueData
 	 */
 	int			markItemIndex;	/* itemIndex, or -1 if not valid */
 
+	/*
+	 * State for prefetching the heap pages referenced by currPos's items
+	 * during plain index scans; see _bt_prefetch_heap.  prefetchItem is the
+	 * last item considered for prefetching, or -1 if the window must be
+	 * restarted at the current item (after reading a new page, say).
+	 */
+	int			prefetchMaximum;	/* max heap pages ahead, or 0 to disable */
+	int			prefetchTarget; /* current heap pages ahead, ramps up */
+	int			prefetchPending;	/* heap pages prefetched, not yet reached */
+	int			prefetchItem;	/* currPos.items index, or -1 */
+	BlockNumber prefetchBlock;	/* heap page of prefetchItem */
+	BlockNumber returnedBlock;	/* heap page of last item returned */
+
 	/* keep these last in struct for efficiency */
 	BTScanPosData currPos;		/* current position data */
 	BTScanPosData markPos;		/* marked position, if any */
@@ -424,6 +424,18 @@
 #define unlikely(x) ((x) != 0)
 #endif
 
+/*
+ * Hint to the CPU that the memory at the given address will be read soon.
+ * This never faults, so it's fine to pass addresses that turn out not to be
+ * used, including NULL.  Like the branch hints above, use sparingly: it only
+ * helps if there's enough other work to do before the memory is accessed.
+ */
+#ifdef __GNUC__
+#define pg_prefetch_mem(addr)	__builtin_prefetch(addr)
+#else
+#define pg_prefetch_mem(addr)	((void) (addr))
+#endif
+
 /*
  * Provide typeof in C++ for C++ compilers that don't support typeof natively.
  * It might be spelled __typeof__ instead of typeof, in which case
@@ -57,6 +57,6 @@
  */
 
 /*							yyyymmddN */
-#define CATALOG_VERSION_NO	202603061
+#define CATALOG_VERSION_NO	202610143
 
 #endif
@@ -14,6 +14,7 @@
 #ifndef HASHJOIN_H
 #define HASHJOIN_H
 
+#include "lib/bloomfilter.h"
 #include "nodes/execnodes.h"
 #include "port/atomics.h"
 #include "storage/barrier.h"
@@ -121,6 +122,13 @@ typedef struct HashSkewBucket
 #define SKEW_HASH_MEM_PERCENT  2
 #define SKEW_MIN_OUTER_FRACTION  0.01
 
+/*
+ * A multi-batch join also keeps a Bloom filter over the hash values of all
+ * inner tuples (see ExecHashCreateInnerFilter), which may use up to this
+ * much of the memory allowed for the join.
+ */
+#define INNER_FILTER_HASH_MEM_PERCENT  25
+
 /*
  * To reduce palloc overhead, the HashJoinTuples for the current batch are
  * packed in 32kB buffers instead of pallocing each tuple individually.
@@ -341,6 +349,15 @@ typedef struct HashJoinTableData
 	BufFile   **innerBatchFile; /* buffered virtual temp file per batch */
 	BufFile   **outerBatchFile; /* buffered virtual temp file per batch */
 
+	/*
+	 * Bloom filter over the hash values of all inner tuples, in any batch.
+	 * Built only for multi-batch, parallel-oblivious joins, so that outer
+	 * tuples that cannot have a match needn't be written to a batch file.
+	 * Its size is included in spaceUsed for as long as the join runs.
+	 */
+	bloom_filter *innerFilter;
+	Size		innerFilterSpace;	/* memory space used by innerFilter */
+
 	Size		spaceUsed;		/* memory space currently used by tuples */
 	Size		spaceAllowed;	/* upper limit for space used */
 	Size		spacePeak;		/* peak space used */
@@ -55,6 +55,8 @@ typedef struct WalUsage
 	uint64		wal_bytes;		/* size of WAL records produced */
 	uint64		wal_fpi_bytes;	/* size of WAL full page images produced */
 	int64		wal_buffers_full;	/* # of times the WAL buffers became full */
+	int64		wal_flush_requests; /* # of XLogFlush calls needing a flush */
+	int64		wal_group_flushes;	/* # of flushes done for such requests */
 } WalUsage;
 
 /* Flag bits included in InstrAlloc's instrument_options bitmask */
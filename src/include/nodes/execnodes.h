@@ -2312,6 +2312,8 @@ typedef struct MemoizeState
 										 * populating the cache. */
 	struct MemoizeEntry *entry; /* the entry that 'last_tuple' belongs to or
 								 * NULL if 'last_tuple' is NULL. */
+	struct MemoizeEntry *last_lookup;	/* entry returned by the previous
+										 * cache_lookup, or NULL */
 	bool		singlerow;		/* true if the cache entry is to be marked as
 								 * complete after caching the first tuple. */
 	bool		binary_mode;	/* true when cache key should be compared bit
@@ -218,7 +218,7 @@ typedef struct PgStat_TableXactStatus
  * ------------------------------------------------------------
  */
 
-#define PGSTAT_FILE_FORMAT_ID	0x01A5BCBB
+#define PGSTAT_FILE_FORMAT_ID	0x01A5BCBD
 
 typedef struct PgStat_ArchiverStats
 {
@@ -418,6 +418,8 @@ typedef struct PgStat_SLRUStats
 	PgStat_Counter blocks_exists;
 	PgStat_Counter flush;
 	PgStat_Counter truncate;
+	PgStat_Counter blk_read_time;	/* times in microseconds */
+	PgStat_Counter blk_write_time;
 	TimestampTz stat_reset_timestamp;
 } PgStat_SLRUStats;
 
@@ -484,6 +486,8 @@ typedef struct PgStat_WalCounters
 	uint64		wal_bytes;
 	uint64		wal_fpi_bytes;
 	PgStat_Counter wal_buffers_full;
+	PgStat_Counter wal_flush_requests;
+	PgStat_Counter wal_group_flushes;
 } PgStat_WalCounters;
 
 /* -------
@@ -770,6 +774,8 @@ extern void pgstat_count_slru_blocks_written(int slru_idx);
 extern void pgstat_count_slru_blocks_exists(int slru_idx);
 extern void pgstat_count_slru_flush(int slru_idx);
 extern void pgstat_count_slru_truncate(int slru_idx);
+extern void pgstat_count_slru_read_time(int slru_idx, instr_time io_start);
+extern void pgstat_count_slru_write_time(int slru_idx, instr_time io_start);
 extern const char *pgstat_get_slru_name(int slru_idx);
 extern int	pgstat_get_slru_index(const char *name);
 extern PgStat_SLRUStats *pgstat_fetch_slru(void);
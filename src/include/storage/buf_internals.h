@@ -567,9 +567,18 @@ extern BufferDesc *StrategyGetBuffer(BufferAccessStrategy strategy,
 									 uint64 *buf_state, bool *from_ring);
 extern bool StrategyRejectBuffer(BufferAccessStrategy strategy,
 								 BufferDesc *buf, bool from_ring);
+extern Buffer StrategyPeekRing(BufferAccessStrategy strategy, int offset);
 
-extern int	StrategySyncStart(uint32 *complete_passes, uint32 *num_buf_alloc);
+extern int	StrategySyncStart(int partno, int *first_buffer, int *num_buffers,
+							  uint32 *complete_passes, uint32 *num_buf_alloc);
+extern void StrategyBalancePartitions(void);
 extern void StrategyNotifyBgWriter(int bgwprocno);
+extern int	StrategyNumPartitions(void);
+extern void StrategyGetPartitionInfo(int partno, int *first_buffer,
+									 int *num_buffers, int *numa_node,
+									 uint32 *next_victim_buffer,
+									 uint32 *complete_passes,
+									 uint64 *buffer_allocs);
 
 extern Size StrategyShmemSize(void);
 extern void StrategyInitialize(bool init);
@@ -186,6 +186,10 @@ extern PGDLLIMPORT const PgAioHandleCallbacks aio_local_buffer_readv_cb;
 /* in buf_init.c */
 extern PGDLLIMPORT char *BufferBlocks;
 
+/* in freelist.c */
+extern PGDLLIMPORT int clock_sweep_partitions;
+extern PGDLLIMPORT bool shared_buffers_numa;
+
 /* in localbuf.c */
 extern PGDLLIMPORT int NLocBuffer;
 extern PGDLLIMPORT Block *LocalBufferBlockPointers;
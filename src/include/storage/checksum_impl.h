@@ -142,8 +142,8 @@ do { \
  * Block checksum algorithm.  The page must be adequately aligned
  * (at least on 4-byte boundary).
  */
-static uint32
-pg_checksum_block(const PGChecksummablePage *page)
+static pg_attribute_always_inline uint32
+pg_checksum_block_inline(const PGChecksummablePage *page)
 {
 	uint32		sums[N_SUMS];
 	uint32		result = 0;
@@ -173,6 +173,22 @@ pg_checksum_block(const PGChecksummablePage *page)
 	return result;
 }
 
+/*
+ * An includer that wants to pick a CPU-specific build of the block checksum
+ * at run time can define PG_CHECKSUM_CUSTOM_BLOCK before including this file,
+ * and then supply its own pg_checksum_block() built on
+ * pg_checksum_block_inline().  The backend does so in checksum.c.
+ */
+#ifdef PG_CHECKSUM_CUSTOM_BLOCK
+static uint32 pg_checksum_block(const PGChecksummablePage *page);
+#else
+static uint32
+pg_checksum_block(const PGChecksummablePage *page)
+{
+	return pg_checksum_block_inline(page);
+}
+#endif
+
 /*
  * Compute the checksum for a Postgres page.
  *
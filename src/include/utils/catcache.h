@@ -63,6 +63,7 @@ typedef struct catcache
 	slist_node	cc_next;		/* list link */
 	ScanKeyData cc_skey[CATCACHE_MAXKEYS];	/* precomputed key info for heap
 											 * scans */
+	int			cc_evict_bucket;	/* next bucket to sweep when evicting */
 
 	/*
 	 * Keep these at the end, so that compiling catcache.c with CATCACHE_STATS
@@ -79,6 +80,7 @@ typedef struct catcache
 	 * searches, each of which will result in loading a negative entry
 	 */
 	uint64		cc_invals;		/* # of entries invalidated from cache */
+	uint64		cc_evictions;	/* # of entries evicted to respect limit */
 	uint64		cc_lsearches;	/* total # list-searches */
 	uint64		cc_lhits;		/* # of matches against existing lists */
 #endif
@@ -121,6 +123,7 @@ typedef struct catctup
 	int			refcount;		/* number of active references */
 	bool		dead;			/* dead but not yet removed? */
 	bool		negative;		/* negative cache entry? */
+	bool		recent;			/* used since last eviction sweep? */
 	HeapTupleData tuple;		/* tuple management header */
 
 	/*
@@ -193,6 +196,9 @@ typedef struct catcacheheader
 /* this extern duplicates utils/memutils.h... */
 extern PGDLLIMPORT MemoryContext CacheMemoryContext;
 
+/* GUC parameter */
+extern PGDLLIMPORT int catalog_cache_max_entries;
+
 extern void CreateCacheMemoryContext(void);
 
 extern CatCache *InitCatCache(int id, Oid reloid, Oid indexoid,
@@ -344,6 +344,9 @@ extern Tuplesortstate *tuplesort_begin_common(int workMem,
 											  int sortopt);
 extern void tuplesort_set_bound(Tuplesortstate *state, int64 bound);
 extern bool tuplesort_used_bound(Tuplesortstate *state);
+extern bool tuplesort_in_bounded_heap(Tuplesortstate *state);
+extern bool tuplesort_bounded_discard(Tuplesortstate *state, Datum datum1,
+									  bool isnull1);
 extern void tuplesort_puttuple_common(Tuplesortstate *state,
 									  SortTuple *tuple, bool useAbbrev,
 									  Size tuplen);
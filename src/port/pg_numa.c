@@ -29,6 +29,7 @@
 
 #include <numa.h>
 #include <numaif.h>
+#include <sched.h>
 
 /*
  * numa_move_pages() chunk size, has to be <= 16 to work around a kernel bug
@@ -118,6 +119,45 @@ pg_numa_get_max_node(void)
 	return numa_max_node();
 }
 
+/*
+ * Return the NUMA node of the CPU the calling process is currently running
+ * on, or -1 if that can't be determined.  The process may of course be
+ * migrated to another node at any time.
+ */
+int
+pg_numa_get_current_node(void)
+{
+	int			cpu = sched_getcpu();
+
+	if (cpu < 0)
+		return -1;
+
+	return numa_node_of_cpu(cpu);
+}
+
+/*
+ * Set the memory policy of the given range, which must be aligned to the
+ * memory page size, to prefer allocating pages on the given node.  Pages
+ * already faulted in are migrated there, if possible.  Returns 0 on success,
+ * -1 on failure with errno set.
+ */
+int
+pg_numa_prefer_node(void *ptr, Size size, int node)
+{
+	struct bitmask *nodemask;
+	int			ret;
+
+	nodemask = numa_allocate_nodemask();
+	numa_bitmask_setbit(nodemask, node);
+
+	ret = mbind(ptr, size, MPOL_PREFERRED, nodemask->maskp, nodemask->size + 1,
+				MPOL_MF_MOVE);
+
+	numa_free_nodemask(nodemask);
+
+	return ret;
+}
+
 #else
 
 /* Empty wrappers */
@@ -140,4 +180,17 @@ pg_numa_get_max_node(void)
 	return 0;
 }
 
+int
+pg_numa_get_current_node(void)
+{
+	return -1;
+}
+
+int
+pg_numa_prefer_node(void *ptr, Size size, int node)
+{
+	errno = ENOSYS;
+	return -1;
+}
+
 #endif
@@ -24,12 +24,27 @@ EXCEPTION /* generates a subxid */
   WHEN raise_exception THEN NULL;
 END;
 $$;
+
+CREATE OR REPLACE FUNCTION gen_subxids_ins (n integer)
+ RETURNS VOID
+ LANGUAGE plpgsql
+AS $$
+BEGIN
+  INSERT INTO subxids VALUES (2, n);
+  IF n > 0 THEN
+    PERFORM gen_subxids_ins(n - 1);
+  END IF;
+EXCEPTION /* generates a subxid */
+  WHEN raise_exception THEN NULL;
+END;
+$$;
 }
 
 teardown
 {
  DROP TABLE subxids;
  DROP FUNCTION gen_subxids(integer);
+ DROP FUNCTION gen_subxids_ins(integer);
 }
 
 session s1
@@ -37,6 +52,8 @@ session s1
 step ins	{ TRUNCATE subxids; INSERT INTO subxids VALUES (0, 0); }
 # long running transaction with overflowed subxids
 step subxov	{ BEGIN; SELECT gen_subxids(100); }
+# same, inserting a row in each of the nested subxids
+step subxins	{ BEGIN; SELECT gen_subxids_ins(100); }
 # commit should always come last to make this long running
 step s1c	{ COMMIT; }
 
@@ -57,6 +74,9 @@ step s2c	{ COMMIT; }
 # step for test3
 step s2upd	{ UPDATE subxids SET val = 1 WHERE subx = 0; }
 
+# step for test4
+step s2cnt	{ SELECT count(*) FROM subxids WHERE subx = 2; }
+
 session s3
 # transaction with subxids that can commit before s1c
 step sub3	{ BEGIN; SAVEPOINT s; INSERT INTO subxids VALUES (1, 0); }
@@ -77,3 +97,9 @@ permutation ins subxov sub3 xmax s2brc s2s3 s3c s2s3 s2c s1c
 # test3
 # designed to test XactLockTableWait() for overflows
 permutation ins subxov xmax s2upd s1c
+
+# test4
+# designed to test the topmost-parent cache of SubTransGetTopmostTransaction():
+# the second SELECT finds the nested subxids' parents in the cache, and must
+# still see them as running; after commit, the rows are visible
+permutation ins subxins xmax s2brr s2cnt s2cnt s2c s1c s2cnt
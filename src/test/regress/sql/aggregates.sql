@@ -1610,8 +1610,31 @@ FROM (SELECT * FROM tenk1
       UNION ALL SELECT * FROM tenk1
       UNION ALL SELECT * FROM tenk1) u;
 
+-- approx_count_distinct covers approx_count_distinct_combine/serialize/deserialize
+EXPLAIN (COSTS OFF, VERBOSE)
+SELECT approx_count_distinct(unique1)
+FROM (SELECT * FROM tenk1
+      UNION ALL SELECT * FROM tenk1
+      UNION ALL SELECT * FROM tenk1
+      UNION ALL SELECT * FROM tenk1) u;
+
+SELECT approx_count_distinct(unique1) BETWEEN 9900 AND 10100 AS ok
+FROM (SELECT * FROM tenk1
+      UNION ALL SELECT * FROM tenk1
+      UNION ALL SELECT * FROM tenk1
+      UNION ALL SELECT * FROM tenk1) u;
+
 ROLLBACK;
 
+-- approx_count_distinct
+SELECT approx_count_distinct(g % 1000) BETWEEN 990 AND 1010 AS ok
+FROM generate_series(1, 100000) g;
+SELECT approx_count_distinct(g::text) BETWEEN 97000 AND 103000 AS ok
+FROM generate_series(1, 100000) g;
+SELECT approx_count_distinct(x) FROM (VALUES (NULL::int), (NULL)) v(x);
+SELECT approx_count_distinct(x) FROM (SELECT 1 WHERE false) v(x);
+SELECT approx_count_distinct(point(1, 2));
+
 -- test coverage for dense_rank
 SELECT dense_rank(x) WITHIN GROUP (ORDER BY x) FROM (VALUES (1),(1),(2),(2),(3),(3)) v(x) GROUP BY (x) ORDER BY 1;
 
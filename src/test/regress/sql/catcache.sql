@@ -0,0 +1,39 @@
+--
+-- Tests for catalog caches held to catalog_cache_max_entries
+--
+
+-- Keep every catalog cache far smaller than the lookups below need, so
+-- that entries are evicted and then looked up again.
+SET catalog_cache_max_entries = 10;
+
+DO $$
+BEGIN
+    FOR i IN 1..100 LOOP
+        EXECUTE format('CREATE TEMP TABLE catcache_t%s (c%s int)', i, i);
+    END LOOP;
+END
+$$;
+
+-- name and OID lookups must still agree with pg_class
+SELECT count(*) AS tables,
+       count(*) FILTER (WHERE c.oid::regclass::text <> c.relname OR
+                              c.relname::text::regclass <> c.oid) AS mismatches
+FROM pg_class c
+WHERE c.relnamespace = pg_my_temp_schema() AND c.relname LIKE 'catcache\_t%';
+
+-- use each table, which needs its relation, type and column entries
+DO $$
+DECLARE
+    total int := 0;
+    v int;
+BEGIN
+    FOR i IN 1..100 LOOP
+        EXECUTE format('INSERT INTO catcache_t%s VALUES (%s)', i, i);
+        EXECUTE format('SELECT c%s FROM catcache_t%s', i, i) INTO v;
+        total := total + v;
+    END LOOP;
+    RAISE NOTICE 'total %', total;
+END
+$$;
+
+RESET catalog_cache_max_entries;
@@ -209,3 +209,22 @@ select * from inttest where a not in (1::myint,2::myint,3::myint,4::myint,5::myi
 select * from inttest where a not in (0::myint,2::myint,3::myint,4::myint,5::myint, null);
 
 rollback;
+
+--
+-- Scan quals are evaluated without starting up the interpreter when they
+-- consist of one or two ANDed "Var op Const" clauses; check that gives the
+-- same results whichever side the Const is on, and with NULLs.
+--
+
+create temp table qualtest (a int, b text);
+insert into qualtest values
+  (1, 'a'), (2, 'b'), (3, 'c'), (4, null), (5, 'e'), (null, 'f');
+
+select count(*) from qualtest where a > 2;
+select count(*) from qualtest where 2 < a;
+select count(*) from qualtest where a <> 3;
+select count(*) from qualtest where b < 'c';
+select count(*) from qualtest where 'c' <= b;
+select count(*) from qualtest where a >= 2 and a < 5;
+select count(*) from qualtest where 1 < a and 4 > a;
+select count(*) from qualtest where 2 <= a and b < 'f';
@@ -211,6 +211,30 @@ $$
 $$);
 rollback to settings;
 
+-- non-parallel, with compressed batch files
+savepoint settings;
+set local max_parallel_workers_per_gather = 0;
+set local work_mem = '128kB';
+set local hash_mem_multiplier = 1.0;
+set local temp_file_compression = pglz;
+select count(*) FROM simple r JOIN bigger_than_it_looks s USING (id);
+select count(*) FROM simple r FULL JOIN bigger_than_it_looks s USING (id);
+rollback to settings;
+
+-- non-parallel, with lz4-compressed batch files, if lz4 is supported
+select enumvals @> '{lz4}' as have_lz4 from pg_settings
+  where name = 'temp_file_compression' \gset
+savepoint settings;
+set local max_parallel_workers_per_gather = 0;
+set local work_mem = '128kB';
+set local hash_mem_multiplier = 1.0;
+\if :have_lz4
+set local temp_file_compression = lz4;
+\endif
+select count(*) FROM simple r JOIN bigger_than_it_looks s USING (id);
+select count(*) FROM simple r FULL JOIN bigger_than_it_looks s USING (id);
+rollback to settings;
+
 -- parallel with parallel-oblivious hash join
 savepoint settings;
 set local max_parallel_workers_per_gather = 2;
@@ -535,6 +559,32 @@ SET enable_parallel_hash = off;
 SELECT * FROM hjtest_matchbits_t1 t1 FULL JOIN hjtest_matchbits_t2 t2 ON t1.id = t2.id;
 ROLLBACK TO settings;
 
+-- A multi-batch parallel-oblivious hash join builds a Bloom filter over the
+-- hash values of the inner tuples, so that outer tuples that can't have a
+-- match needn't be written to batch files.  Make sure that gives the right
+-- results for inner, left and anti joins, where half the outer tuples have
+-- no match.
+savepoint settings;
+set local max_parallel_workers_per_gather = 0;
+set local enable_mergejoin = off;
+set local work_mem = '4MB';
+set local hash_mem_multiplier = 1.0;
+create table bloom_inner as
+  select g * 2 as id, g * 2 as v from generate_series(1, 120000) g;
+create table bloom_outer as
+  select g as id from generate_series(1, 240000) g;
+analyze bloom_inner, bloom_outer;
+select final > 1 as multibatch
+  from hash_join_batches(
+$$
+  select count(*) from bloom_outer o join bloom_inner i using (id);
+$$);
+select count(*), sum(i.v) from bloom_outer o join bloom_inner i using (id);
+select count(*), count(i.id) from bloom_outer o left join bloom_inner i using (id);
+select count(*), sum(o.id) from bloom_outer o
+  where not exists (select from bloom_inner i where i.id = o.id);
+rollback to settings;
+
 rollback;
 
 -- Verify that hash key expressions reference the correct
@@ -305,3 +305,72 @@ EXPLAIN (COSTS OFF) :qry;
 :qry;
 
 COMMIT;
+
+----
+-- test bounded sorts that discard input tuples on their leading key
+----
+
+CREATE TEMP TABLE bounded_sort(a int, b int);
+INSERT INTO bounded_sort
+    SELECT CASE WHEN g % 37 = 0 THEN NULL ELSE (g * 7) % 20 END, g
+    FROM generate_series(1, 2000) g;
+
+-- every returned row ties on the leading key; the second key decides
+SELECT a, b FROM bounded_sort ORDER BY a, b LIMIT 6;
+SELECT a, b FROM bounded_sort ORDER BY a, b DESC LIMIT 6;
+SELECT a, b FROM bounded_sort ORDER BY a NULLS FIRST, b LIMIT 6;
+SELECT a, b FROM bounded_sort ORDER BY a DESC, b LIMIT 6;
+SELECT a, b FROM bounded_sort ORDER BY a DESC NULLS LAST, b DESC LIMIT 6;
+
+-- the bound falls inside a group of leading-key ties
+SELECT a, b FROM bounded_sort WHERE b <= 200 ORDER BY a, b LIMIT 15;
+SELECT a, b FROM bounded_sort WHERE b <= 200 ORDER BY a DESC NULLS LAST, b LIMIT 15;
+
+----
+-- test radix sort of keys that share their leading bytes
+----
+
+CREATE TEMP TABLE radix_prefix(v int8, t text);
+
+-- keys that differ only in their last byte, inserted out of order
+INSERT INTO radix_prefix
+    SELECT 1099511627776 + (i * 37) % 256, NULL FROM generate_series(0, 255) i;
+SELECT count(*) FILTER (WHERE v <> 1099511627776 + rn - 1) AS mismatches, count(*)
+FROM (SELECT v, row_number() OVER (ORDER BY v) AS rn FROM radix_prefix) s;
+SELECT count(*) FILTER (WHERE v <> 1099511627776 + 256 - rn) AS mismatches, count(*)
+FROM (SELECT v, row_number() OVER (ORDER BY v DESC) AS rn FROM radix_prefix) s;
+
+-- keys with a long common prefix
+TRUNCATE radix_prefix;
+INSERT INTO radix_prefix
+    SELECT 72057594037927936 + (i * 7919) % 10000,
+           repeat('common prefix ', 4) || lpad(((i * 7919) % 10000)::text, 5, '0')
+    FROM generate_series(0, 9999) i;
+SELECT count(*) FILTER (WHERE v <> 72057594037927936 + rn - 1) AS mismatches, count(*)
+FROM (SELECT v, row_number() OVER (ORDER BY v) AS rn FROM radix_prefix) s;
+SELECT count(*) FILTER (WHERE t <> repeat('common prefix ', 4) || lpad((rn - 1)::text, 5, '0')) AS mismatches, count(*)
+FROM (SELECT t, row_number() OVER (ORDER BY t COLLATE "C") AS rn FROM radix_prefix) s;
+
+-- every leading key is equal, so only the second key orders the rows
+SELECT count(*) FILTER (WHERE v <> 72057594037927936 + rn - 1) AS mismatches, count(*)
+FROM (SELECT v, row_number() OVER (ORDER BY v >> 16, v) AS rn FROM radix_prefix) s;
+
+----
+-- test external sorts that merge many runs
+----
+
+CREATE TEMP TABLE many_runs(v int, pad text);
+INSERT INTO many_runs
+    SELECT (i * 7919) % 50000 + 1, repeat('x', 50) FROM generate_series(0, 49999) i;
+
+BEGIN;
+
+-- the minimum work_mem spills the input into many sorted runs
+SET LOCAL work_mem = '64kB';
+
+SELECT count(*) FILTER (WHERE v <> rn OR length(pad) <> 50) AS mismatches, count(*)
+FROM (SELECT v, pad, row_number() OVER (ORDER BY v) AS rn FROM many_runs) s;
+SELECT count(*) FILTER (WHERE v <> 50001 - rn OR length(pad) <> 50) AS mismatches, count(*)
+FROM (SELECT v, pad, row_number() OVER (ORDER BY v DESC) AS rn FROM many_runs) s;
+
+COMMIT;